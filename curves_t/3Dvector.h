@@ -1,6 +1,7 @@
 #pragma once
 
 #include "point.h"
+#include "profiler.h"
 
 template <typename T>
 class TriDvector {
@@ -50,6 +51,7 @@ const T TriDvector<T>::GetZ() const {
 
 template<typename T>
 void TriDvector<T>::Normalize() {
+	CURVES_PROFILE_COUNT(Normalize);
 	T len = Distance(
 		Point<T>(0.0, 0.0, 0.0),
 		MakePoint()	// End-of-vector point
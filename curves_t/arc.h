@@ -0,0 +1,95 @@
+#pragma once
+
+#include "curve.h"
+
+// Circular arc in the XY plane: param 0 is at angle start, param 1 - at start + sweep.
+// Negative sweep runs clockwise
+template <typename T>
+class Arc final : public Curve<T> {
+private:		// fields
+	const T rad_;
+	const T start_;
+	const T sweep_;
+
+public:			// constructors
+	Arc() = delete;
+	explicit Arc(T rad, T start, T sweep);
+
+public:			// methods
+	const T GetRad() const;
+	const T GetStart() const;
+	const T GetSweep() const;
+	const Point<T> GetPointByParam(T param) const;
+	void GetPointsByParams(const T* params, std::size_t count, T* xs, T* ys, T* zs) const;
+	const TriDvector<T> GetDerivativeByParam(T param) const;
+
+	const bool IsCircle() const;
+	const CurveKind GetKind() const;
+};
+
+/****************************************** DEFINITIONS ************************************************/
+
+template <typename T>
+Arc<T>::Arc(T rad, T start, T sweep) : rad_(rad), start_(start), sweep_(sweep) {
+	if (!std::is_floating_point<T>::value)
+		throw std::logic_error("Arc coordinate is NOT floating type");
+	if (rad <= 0)
+		throw std::logic_error("Radii must be positive");
+	if (sweep == 0)
+		throw std::logic_error("Arc sweep must be non-zero");
+}
+
+template <typename T>
+const T Arc<T>::GetRad() const {
+	return rad_;
+}
+
+template <typename T>
+const T Arc<T>::GetStart() const {
+	return start_;
+}
+
+template <typename T>
+const T Arc<T>::GetSweep() const {
+	return sweep_;
+}
+
+template <typename T>
+const Point<T> Arc<T>::GetPointByParam(T param) const {
+	CURVES_PROFILE_COUNT(ArcEval);
+	const T angle = start_ + param * sweep_;
+	Point<T> ret(rad_ * std::cos(angle), rad_ * std::sin(angle), 0);
+	return ret;
+}
+
+template <typename T>
+void Arc<T>::GetPointsByParams(const T* params, std::size_t count, T* xs, T* ys, T* zs) const {
+	CURVES_PROFILE_COUNT_N(ArcBatchPoint, count);
+	for (std::size_t i = 0; i < count; ++i) {
+		const T angle = start_ + params[i] * sweep_;
+		xs[i] = rad_ * std::cos(angle);
+		ys[i] = rad_ * std::sin(angle);
+		zs[i] = 0;
+	}
+}
+
+// Follows the sweep direction
+template <typename T>
+const TriDvector<T> Arc<T>::GetDerivativeByParam(T param) const {
+	CURVES_PROFILE_COUNT(ArcDeriv);
+	const T angle = start_ + param * sweep_;
+	const T dir = sweep_ > 0 ? T(1) : T(-1);
+	TriDvector<T> ret(-dir * std::sin(angle), dir * std::cos(angle), 0);
+	ret.Normalize();
+	return ret;
+}
+
+template <typename T>
+const bool Arc<T>::IsCircle() const {
+	return false;
+}
+
+template <typename T>
+const CurveKind Arc<T>::GetKind() const {
+	return CurveKind::Arc;
+}
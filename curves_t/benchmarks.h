@@ -0,0 +1,311 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include <memory>
+
+#include "curve.h"
+#include "circle.h"
+#include "ellipsis.h"
+#include "helix.h"
+#include "intersection.h"
+#include "bulk.h"
+#include "evaluator.h"
+#include "polyline_codec.h"
+#include "sorted_view.h"
+
+// Not run by default - build with CURVES_BENCHMARKS defined to get timings printed after the tests
+
+namespace MyBenchmarks {
+
+	using Clock = std::chrono::steady_clock;
+
+	template <typename F>
+	double MeasureMs(const F& func) {
+		auto start = Clock::now();
+		func();
+		return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+	}
+
+	void Report(const std::string& name, double ms) {
+		std::cout << "[bench] " << name << ": " << ms << " ms" << std::endl;
+	}
+
+	// Mixed set of random curves, owning storage + raw pointers like in main()
+	struct CurveSet {
+		std::vector<std::unique_ptr<Curve<double>>> storage;
+		std::vector<Curve<double>*> curves;
+	};
+
+	CurveSet MakeCurveSet(size_t count, unsigned seed) {
+		std::mt19937 gen(seed);
+		std::uniform_real_distribution<double> distrib_d(1.0, 100.0);
+		CurveSet ret;
+		ret.storage.reserve(count);
+		for (size_t i = 0; i < count; ++i) {
+			switch (i % 3) {
+			case 0: ret.storage.push_back(std::make_unique<Circle<double>>(distrib_d(gen))); break;
+			case 1: ret.storage.push_back(std::make_unique<Ellipsis<double>>(distrib_d(gen), distrib_d(gen))); break;
+			default: ret.storage.push_back(std::make_unique<Helix<double>>(distrib_d(gen), distrib_d(gen))); break;
+			}
+			ret.curves.push_back(ret.storage.back().get());
+		}
+		return ret;
+	}
+
+	// The old way: walk the curve and look for points lying on the plane
+	std::vector<double> SampledPlaneHits(const Curve<double>& c, const Plane<double>& pl, double t0, double t1, int samples) {
+		std::vector<double> ret;
+		const double h = (t1 - t0) / samples;
+		double prev = pl.Eval(c.GetPointByParam(t0));
+		for (int i = 1; i <= samples; ++i) {
+			const double cur = pl.Eval(c.GetPointByParam(t0 + h * i));
+			if ((prev < 0) != (cur < 0))
+				ret.push_back(t0 + h * (i - 0.5));
+			prev = cur;
+		}
+		return ret;
+	}
+
+	void BenchPlaneIntersections() {
+		const CurveSet set = MakeCurveSet(3000, 42);
+		const Plane<double> pl(0.3, 0.5, 0.8, 10.0);
+		const double t0 = 0.0;
+		const double t1 = 20 * 3.14159265358979323846;
+
+		size_t hits_sampled = 0;
+		const double ms_sampled = MeasureMs([&] {
+			for (const Curve<double>* c : set.curves)
+				hits_sampled += SampledPlaneHits(*c, pl, t0, t1, 10000).size();
+		});
+
+		size_t hits_analytic = 0;
+		const double ms_analytic = MeasureMs([&] {
+			for (const auto& hits : IntersectPlane(set.curves, pl, t0, t1))
+				hits_analytic += hits.size();
+		});
+
+		Report("plane hits, sampling x10000 (" + std::to_string(hits_sampled) + " hits)", ms_sampled);
+		Report("plane hits, analytic batch (" + std::to_string(hits_analytic) + " hits)", ms_analytic);
+	}
+
+	void BenchCurveIntersections() {
+		const Circle<double> c(10.0);
+		const Ellipsis<double> e(15.0, 5.0);
+		const double PI = 3.14159265358979323846;
+
+		size_t hits_sampled = 0;
+		const double ms_sampled = MeasureMs([&] {
+			const int n = 4000;
+			for (int i = 0; i < n; ++i)
+				for (int j = 0; j < n; ++j)
+					if (AlmostEqual(c.GetPointByParam(2 * PI * i / n), e.GetPointByParam(2 * PI * j / n)))
+						++hits_sampled;
+		});
+
+		size_t hits_bvh = 0;
+		const double ms_bvh = MeasureMs([&] {
+			hits_bvh = IntersectCurves<double>(c, 0, 2 * PI, e, 0, 2 * PI).size();
+		});
+
+		Report("curve-curve, sampling 4000x4000 (" + std::to_string(hits_sampled) + " hits)", ms_sampled);
+		Report("curve-curve, BVH + Newton (" + std::to_string(hits_bvh) + " hits)", ms_bvh);
+	}
+
+	// Naive helix point with raw trig argument, as it used to be
+	void NaiveHelixPoint(double rad, double step, double param, double& x, double& y, double& z) {
+		const double PI = 3.14159265358979323846;
+		x = rad * std::cos(param);
+		y = rad * std::sin(param);
+		z = (param / (2 * PI)) * step;
+	}
+
+	void BenchDeepHelix() {
+		const Helix<double> h(5.0, 2.0);
+		const size_t n = 2000000;
+		std::vector<double> params(n);
+		std::mt19937 gen(7);
+		std::uniform_real_distribution<double> distrib_d(1e6, 1e9);			// ~1e5..1e8 turns
+		for (double& p : params)
+			p = distrib_d(gen);
+		std::vector<double> xs(n), ys(n), zs(n);
+
+		const double ms_naive = MeasureMs([&] {
+			for (size_t i = 0; i < n; ++i)
+				NaiveHelixPoint(5.0, 2.0, params[i], xs[i], ys[i], zs[i]);
+		});
+		const double ms_batch = MeasureMs([&] {
+			h.GetPointsByParams(params.data(), n, xs.data(), ys.data(), zs.data());
+		});
+
+		Report("deep helix, raw trig argument x" + std::to_string(n), ms_naive);
+		Report("deep helix, range reduced batch x" + std::to_string(n), ms_batch);
+	}
+
+	void BenchBulkConstruction() {
+		const size_t n = 1000000;
+		std::vector<double> rads(n);
+		std::mt19937 gen(11);
+		std::uniform_real_distribution<double> distrib_d(-1.0, 100.0);			// ~1% bad records
+		for (double& r : rads)
+			r = distrib_d(gen);
+
+		size_t bad_one_by_one = 0;
+		const double ms_single = MeasureMs([&] {
+			std::vector<Circle<double>> circles;
+			for (double r : rads) {
+				try {
+					circles.emplace_back(r);
+				}
+				catch (const std::logic_error&) {
+					++bad_one_by_one;
+				}
+			}
+		});
+
+		size_t bad_bulk = 0;
+		const double ms_bulk = MeasureMs([&] {
+			std::vector<Circle<double>> circles;
+			bad_bulk = BuildCircles(rads, circles).GetInvalidCount();
+		});
+
+		Report("circle construction, try/catch per record (" + std::to_string(bad_one_by_one) + " bad)", ms_single);
+		Report("circle construction, bulk validated (" + std::to_string(bad_bulk) + " bad)", ms_bulk);
+	}
+
+	// Per-call latency distribution: calls are timed in small groups (clock reads cost more than one call),
+	// percentiles are over the per-call averages of the groups
+	template <typename F>
+	void ReportLatency(const std::string& name, const F& call) {
+		const size_t groups = 200000;
+		const size_t group = 16;
+		std::vector<double> ns(groups);
+		for (size_t g = 0; g < groups; ++g) {
+			auto start = Clock::now();
+			for (size_t i = 0; i < group; ++i)
+				call(g * group + i);
+			ns[g] = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / group;
+		}
+		std::sort(ns.begin(), ns.end());
+		auto pct = [&ns](double p) { return ns[static_cast<size_t>(p * (ns.size() - 1))]; };
+		std::cout << "[bench] " << name << " per call: p50 " << pct(0.5) << " ns, p99 " << pct(0.99)
+			<< " ns, p99.9 " << pct(0.999) << " ns" << std::endl;
+	}
+
+	void BenchSinglePointLatency() {
+		const Helix<double> h(5.0, 2.0);
+		const Ellipsis<double> e(3.0, 1.5);
+		const HelixEvaluator<double> he = MakeEvaluator(h);
+		const EllipsisEvaluator<double> ee = MakeEvaluator(e);
+		volatile double sink = 0;			// keeps the calls alive
+
+		ReportLatency("helix point, Curve<T>", [&](size_t i) {
+			sink = h.GetPointByParam(0.001 * static_cast<double>(i)).GetZ();
+		});
+		ReportLatency("helix point, evaluator", [&](size_t i) {
+			double x, y, z;
+			he.GetPoint(0.001 * static_cast<double>(i), x, y, z);
+			sink = z;
+		});
+		ReportLatency("helix tangent, Curve<T>", [&](size_t i) {
+			sink = h.GetDerivativeByParam(0.001 * static_cast<double>(i)).GetX();
+		});
+		ReportLatency("helix tangent, evaluator", [&](size_t i) {
+			double x, y, z;
+			he.GetTangent(0.001 * static_cast<double>(i), x, y, z);
+			sink = x;
+		});
+		ReportLatency("ellipsis tangent, Curve<T>", [&](size_t i) {
+			sink = e.GetDerivativeByParam(0.001 * static_cast<double>(i)).GetX();
+		});
+		ReportLatency("ellipsis tangent, evaluator", [&](size_t i) {
+			double x, y, z;
+			ee.GetTangent(0.001 * static_cast<double>(i), x, y, z);
+			sink = x;
+		});
+	}
+
+	void BenchPolylineCodec() {
+		const Helix<double> h(25.0, 3.0);
+		const size_t n = 1000000;
+		std::vector<double> params(n), xs(n), ys(n), zs(n);
+		for (size_t i = 0; i < n; ++i)
+			params[i] = 1e-3 * static_cast<double>(i);
+		h.GetPointsByParams(params.data(), n, xs.data(), ys.data(), zs.data());
+
+		EncodedPolyline<double> enc;
+		const double ms_encode = MeasureMs([&] {
+			enc = EncodePolyline(xs.data(), ys.data(), zs.data(), n, 1e-4);
+		});
+		const double ms_decode = MeasureMs([&] {
+			DecodePolyline(enc, xs.data(), ys.data(), zs.data());
+		});
+
+		const size_t dense = n * 3 * sizeof(double);
+		Report("polyline encode x" + std::to_string(n) + " (" + std::to_string(dense) + " -> " + std::to_string(enc.GetByteSize()) + " bytes)", ms_encode);
+		Report("polyline decode x" + std::to_string(n), ms_decode);
+	}
+
+	// Per-frame radius jitter on many circles: objects rebuilt and re-sorted vs columns updated in place
+	void BenchAnimationTick() {
+		const size_t n = 200000;
+		const int frames = 50;
+		std::mt19937 gen(5);
+		std::uniform_real_distribution<double> distrib_d(1.0, 100.0);
+		std::uniform_real_distribution<double> jitter(-0.01, 0.01);
+		std::vector<double> rads(n);
+		for (double& r : rads)
+			r = distrib_d(gen);
+		std::vector<std::vector<double>> deltas(frames, std::vector<double>(n));
+		for (auto& frame : deltas)
+			for (double& d : frame)
+				d = jitter(gen);
+
+		std::vector<double> current = rads;
+		const double ms_rebuild = MeasureMs([&] {
+			for (const auto& frame : deltas) {
+				for (size_t i = 0; i < n; ++i)
+					current[i] += frame[i];
+				std::vector<Circle<double>> circles;
+				circles.reserve(n);
+				for (double r : current)
+					circles.emplace_back(r);
+				std::vector<const Circle<double>*> sorted;
+				sorted.reserve(n);
+				for (const Circle<double>& c : circles)
+					sorted.push_back(&c);
+				std::sort(sorted.begin(), sorted.end(),
+					[](const Circle<double>* lhs, const Circle<double>* rhs) { return lhs->GetRad() < rhs->GetRad(); });
+			}
+		});
+
+		CurveStore<double> store;
+		for (double r : rads)
+			store.AddCircle(r);
+		SortedView<double> view(store, CurveKind::Circle, 0);
+		const double ms_incremental = MeasureMs([&] {
+			for (const auto& frame : deltas) {
+				store.ApplyDeltas(0, frame.data());
+				view.Update(store);
+			}
+		});
+
+		Report("animation x" + std::to_string(frames) + " frames, rebuild + sort " + std::to_string(n) + " circles", ms_rebuild);
+		Report("animation x" + std::to_string(frames) + " frames, ApplyDeltas + incremental order", ms_incremental);
+	}
+
+	void RunBenchmarks() {
+		BenchBulkConstruction();
+		BenchDeepHelix();
+		BenchPlaneIntersections();
+		BenchCurveIntersections();
+		BenchSinglePointLatency();
+		BenchPolylineCodec();
+		BenchAnimationTick();
+	}
+
+}		// namespace MyBenchmarks
@@ -0,0 +1,173 @@
+#pragma once
+
+#include "curve.h"
+
+/*********************************** Implementation details ***************************************/
+
+namespace SplineDetail {
+
+	template <typename T>
+	inline T Lerp(T a, T b, T t) {
+		return a + t * (b - a);
+	}
+
+	// Cubic in Bezier form, one coordinate array per axis - loops over params vectorize per axis
+	template <typename T>
+	struct Cubic {
+		T x[4];
+		T y[4];
+		T z[4];
+
+		// de Casteljau: only lerps, stable for any param in [0, 1]
+		static T Eval(const T* c, T t) {
+			const T a = Lerp(c[0], c[1], t);
+			const T b = Lerp(c[1], c[2], t);
+			const T d = Lerp(c[2], c[3], t);
+			return Lerp(Lerp(a, b, t), Lerp(b, d, t), t);
+		}
+
+		// derivative of a cubic is 3 * quadratic over control point differences
+		static T Slope(const T* c, T t) {
+			return 3 * Lerp(Lerp(c[1] - c[0], c[2] - c[1], t), Lerp(c[2] - c[1], c[3] - c[2], t), t);
+		}
+
+		// second derivative: 6 * line over second differences
+		static T Accel(const T* c, T t) {
+			return 6 * Lerp(c[2] - 2 * c[1] + c[0], c[3] - 2 * c[2] + c[1], t);
+		}
+
+		// third derivative is constant
+		static T Jerk(const T* c) {
+			return 6 * (c[3] - 3 * c[2] + 3 * c[1] - c[0]);
+		}
+
+		const bool IsDegenerate() const {
+			for (int k = 1; k < 4; ++k)
+				if (x[k] != x[0] || y[k] != y[0] || z[k] != z[0])
+					return false;
+			return true;
+		}
+
+		void GetPoints(const T* params, std::size_t count, T* xs, T* ys, T* zs) const {
+			for (std::size_t i = 0; i < count; ++i) {
+				xs[i] = Eval(x, params[i]);
+				ys[i] = Eval(y, params[i]);
+				zs[i] = Eval(z, params[i]);
+			}
+		}
+
+		// Tangent vanishes where control points coincide (e.g. P0 == P1 at t = 0). The curve still has a direction there:
+		// near a zero of B', B'(t0 + h) ~ h * B''(t0), so it leaves along B'' (P2 - P0 at t = 0) and arrives along -B''
+		// (P3 - P1 at t = 1). With B'' zero too (three coincident points) B' ~ h^2 / 2 * B''' keeps its sign.
+		// Only a curve collapsed to a point has none of them - the chord P0 -> P3 is what's left
+		const TriDvector<T> GetTangent(T t) const {
+			T dx = Slope(x, t);
+			T dy = Slope(y, t);
+			T dz = Slope(z, t);
+			if (dx == 0 && dy == 0 && dz == 0) {
+				const T side = t < 1 ? T(1) : T(-1);
+				dx = side * Accel(x, t);
+				dy = side * Accel(y, t);
+				dz = side * Accel(z, t);
+			}
+			if (dx == 0 && dy == 0 && dz == 0) {
+				dx = Jerk(x);
+				dy = Jerk(y);
+				dz = Jerk(z);
+			}
+			if (dx == 0 && dy == 0 && dz == 0) {
+				dx = x[3] - x[0];
+				dy = y[3] - y[0];
+				dz = z[3] - z[0];
+			}
+			TriDvector<T> ret(dx, dy, dz);
+			ret.Normalize();
+			return ret;
+		}
+	};
+
+	template <typename T>
+	Cubic<T> MakeCubic(const Point<T>& p0, const Point<T>& p1, const Point<T>& p2, const Point<T>& p3) {
+		return Cubic<T>{
+			{ p0.GetX(), p1.GetX(), p2.GetX(), p3.GetX() },
+			{ p0.GetY(), p1.GetY(), p2.GetY(), p3.GetY() },
+			{ p0.GetZ(), p1.GetZ(), p2.GetZ(), p3.GetZ() }
+		};
+	}
+
+	template <typename T>
+	const Point<T> ControlPoint(const Cubic<T>& c, std::size_t index) {
+		if (index > 3)
+			throw std::logic_error("Control point index out of range");
+		return Point<T>(c.x[index], c.y[index], c.z[index]);
+	}
+
+}		// namespace SplineDetail
+
+/*********************************** BezierSegment ***************************************/
+
+// Cubic Bezier curve, param in [0, 1] from the first control point to the last one
+template <typename T>
+class BezierSegment final : public Curve<T> {
+private:		// fields
+	const SplineDetail::Cubic<T> ctrl_;
+
+public:			// constructors
+	BezierSegment() = delete;
+	explicit BezierSegment(const Point<T>& p0, const Point<T>& p1, const Point<T>& p2, const Point<T>& p3);
+
+public:			// methods
+	const Point<T> GetControlPoint(std::size_t index) const;
+	const Point<T> GetPointByParam(T param) const;
+	void GetPointsByParams(const T* params, std::size_t count, T* xs, T* ys, T* zs) const;
+	const TriDvector<T> GetDerivativeByParam(T param) const;
+
+	const bool IsCircle() const;
+	const CurveKind GetKind() const;
+};
+
+/****************************************** DEFINITIONS ************************************************/
+
+template <typename T>
+BezierSegment<T>::BezierSegment(const Point<T>& p0, const Point<T>& p1, const Point<T>& p2, const Point<T>& p3)
+	: ctrl_(SplineDetail::MakeCubic(p0, p1, p2, p3)) {
+	if (!std::is_floating_point<T>::value)
+		throw std::logic_error("BezierSegment coordinate is NOT floating type");
+	if (ctrl_.IsDegenerate())
+		throw std::logic_error("Spline control points must not all coincide");
+}
+
+template <typename T>
+const Point<T> BezierSegment<T>::GetControlPoint(std::size_t index) const {
+	return SplineDetail::ControlPoint(ctrl_, index);
+}
+
+template <typename T>
+const Point<T> BezierSegment<T>::GetPointByParam(T param) const {
+	CURVES_PROFILE_COUNT(BezierEval);
+	using Cubic = SplineDetail::Cubic<T>;
+	Point<T> ret(Cubic::Eval(ctrl_.x, param), Cubic::Eval(ctrl_.y, param), Cubic::Eval(ctrl_.z, param));
+	return ret;
+}
+
+template <typename T>
+void BezierSegment<T>::GetPointsByParams(const T* params, std::size_t count, T* xs, T* ys, T* zs) const {
+	CURVES_PROFILE_COUNT_N(BezierBatchPoint, count);
+	ctrl_.GetPoints(params, count, xs, ys, zs);
+}
+
+template <typename T>
+const TriDvector<T> BezierSegment<T>::GetDerivativeByParam(T param) const {
+	CURVES_PROFILE_COUNT(BezierDeriv);
+	return ctrl_.GetTangent(param);
+}
+
+template <typename T>
+const bool BezierSegment<T>::IsCircle() const {
+	return false;
+}
+
+template <typename T>
+const CurveKind BezierSegment<T>::GetKind() const {
+	return CurveKind::Bezier;
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "curve.h"
+#include "bezier.h"
+
+// One segment of a uniform cubic B-spline, param in [0, 1].
+// Converted to Bezier form once in the constructor, so evaluation is the same de Casteljau as BezierSegment
+template <typename T>
+class BSplineSegment final : public Curve<T> {
+private:		// fields
+	const SplineDetail::Cubic<T> ctrl_;			// de Boor points as given
+	const SplineDetail::Cubic<T> bezier_;
+
+public:			// constructors
+	BSplineSegment() = delete;
+	explicit BSplineSegment(const Point<T>& p0, const Point<T>& p1, const Point<T>& p2, const Point<T>& p3);
+
+public:			// methods
+	const Point<T> GetControlPoint(std::size_t index) const;
+	// Same curve in Bezier form - what evaluation runs on
+	const SplineDetail::Cubic<T>& GetBezier() const;
+	const Point<T> GetPointByParam(T param) const;
+	void GetPointsByParams(const T* params, std::size_t count, T* xs, T* ys, T* zs) const;
+	const TriDvector<T> GetDerivativeByParam(T param) const;
+
+	const bool IsCircle() const;
+	const CurveKind GetKind() const;
+
+private:
+	static SplineDetail::Cubic<T> ToBezier(const SplineDetail::Cubic<T>& b);
+};
+
+/****************************************** DEFINITIONS ************************************************/
+
+template <typename T>
+BSplineSegment<T>::BSplineSegment(const Point<T>& p0, const Point<T>& p1, const Point<T>& p2, const Point<T>& p3)
+	: ctrl_(SplineDetail::MakeCubic(p0, p1, p2, p3)), bezier_(ToBezier(ctrl_)) {
+	if (!std::is_floating_point<T>::value)
+		throw std::logic_error("BSplineSegment coordinate is NOT floating type");
+	if (bezier_.IsDegenerate())
+		throw std::logic_error("Spline control points must not all coincide");
+}
+
+// Uniform cubic basis in Bezier terms:
+// B0 = (P0 + 4P1 + P2) / 6, B1 = (2P1 + P2) / 3, B2 = (P1 + 2P2) / 3, B3 = (P1 + 4P2 + P3) / 6
+template <typename T>
+SplineDetail::Cubic<T> BSplineSegment<T>::ToBezier(const SplineDetail::Cubic<T>& b) {
+	SplineDetail::Cubic<T> ret;
+	auto convert = [](const T* p, T* out) {
+		out[0] = (p[0] + 4 * p[1] + p[2]) / 6;
+		out[1] = (2 * p[1] + p[2]) / 3;
+		out[2] = (p[1] + 2 * p[2]) / 3;
+		out[3] = (p[1] + 4 * p[2] + p[3]) / 6;
+	};
+	convert(b.x, ret.x);
+	convert(b.y, ret.y);
+	convert(b.z, ret.z);
+	return ret;
+}
+
+template <typename T>
+const Point<T> BSplineSegment<T>::GetControlPoint(std::size_t index) const {
+	return SplineDetail::ControlPoint(ctrl_, index);
+}
+
+template <typename T>
+const SplineDetail::Cubic<T>& BSplineSegment<T>::GetBezier() const {
+	return bezier_;
+}
+
+template <typename T>
+const Point<T> BSplineSegment<T>::GetPointByParam(T param) const {
+	CURVES_PROFILE_COUNT(BSplineEval);
+	using Cubic = SplineDetail::Cubic<T>;
+	Point<T> ret(Cubic::Eval(bezier_.x, param), Cubic::Eval(bezier_.y, param), Cubic::Eval(bezier_.z, param));
+	return ret;
+}
+
+template <typename T>
+void BSplineSegment<T>::GetPointsByParams(const T* params, std::size_t count, T* xs, T* ys, T* zs) const {
+	CURVES_PROFILE_COUNT_N(BSplineBatchPoint, count);
+	bezier_.GetPoints(params, count, xs, ys, zs);
+}
+
+template <typename T>
+const TriDvector<T> BSplineSegment<T>::GetDerivativeByParam(T param) const {
+	CURVES_PROFILE_COUNT(BSplineDeriv);
+	return bezier_.GetTangent(param);
+}
+
+template <typename T>
+const bool BSplineSegment<T>::IsCircle() const {
+	return false;
+}
+
+template <typename T>
+const CurveKind BSplineSegment<T>::GetKind() const {
+	return CurveKind::BSpline;
+}
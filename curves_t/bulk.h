@@ -0,0 +1,177 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include "curve.h"
+#include "circle.h"
+#include "ellipsis.h"
+#include "helix.h"
+
+// Bulk construction for ingesting big parameter arrays.
+// Whole arrays are validated up front with branch-free checks, bad records are reported
+// in a bitmask instead of an exception, and only the valid curves get constructed -
+// their constructors can't throw anymore, so one bad record doesn't unwind the whole load.
+
+class BulkReport {
+private:			// fields
+	std::vector<uint64_t> invalid_mask_;		// bit i set => record i is invalid
+	size_t total_ = 0;
+	size_t invalid_ = 0;
+
+public:				// constructors
+	BulkReport() = default;
+	explicit BulkReport(size_t total);
+
+public:				// methods
+	const size_t GetTotal() const;
+	const size_t GetInvalidCount() const;
+	const size_t GetValidCount() const;
+	const bool IsValid(size_t index) const;
+	const std::vector<uint64_t>& GetMask() const;
+	std::vector<size_t> GetInvalidIndices() const;
+
+	// ORs in 64 flags for records [64 * word, 64 * word + 63]
+	void MarkWord(size_t word, uint64_t bits);
+};
+
+/****************************************** DEFINITIONS ************************************************/
+
+inline BulkReport::BulkReport(size_t total) : invalid_mask_((total + 63) / 64, 0), total_(total) {
+}
+
+inline const size_t BulkReport::GetTotal() const {
+	return total_;
+}
+
+inline const size_t BulkReport::GetInvalidCount() const {
+	return invalid_;
+}
+
+inline const size_t BulkReport::GetValidCount() const {
+	return total_ - invalid_;
+}
+
+inline const bool BulkReport::IsValid(size_t index) const {
+	return ((invalid_mask_[index / 64] >> (index % 64)) & 1) == 0;
+}
+
+inline const std::vector<uint64_t>& BulkReport::GetMask() const {
+	return invalid_mask_;
+}
+
+inline std::vector<size_t> BulkReport::GetInvalidIndices() const {
+	std::vector<size_t> ret;
+	ret.reserve(invalid_);
+	for (size_t w = 0; w < invalid_mask_.size(); ++w)
+		for (uint64_t bits = invalid_mask_[w]; bits != 0; bits &= bits - 1) {
+			size_t bit = 0;
+			while (((bits >> bit) & 1) == 0)
+				++bit;
+			ret.push_back(w * 64 + bit);
+		}
+	return ret;
+}
+
+inline void BulkReport::MarkWord(size_t word, uint64_t bits) {
+	const uint64_t added = bits & ~invalid_mask_[word];
+	for (uint64_t b = added; b != 0; b &= b - 1)
+		++invalid_;
+	invalid_mask_[word] |= bits;
+}
+
+/*********************************** Implementation details ***************************************/
+
+namespace BulkDetail {
+
+	// Blocks of 64 records -> one mask word. The inner loop has no branches, so it vectorizes;
+	// `bad(i)` must be a plain comparison expression
+	template <typename Bad>
+	BulkReport Validate(size_t count, const Bad& bad) {
+		BulkReport report(count);
+		for (size_t base = 0; base < count; base += 64) {
+			const size_t n = std::min<size_t>(64, count - base);
+			uint64_t bits = 0;
+			for (size_t j = 0; j < n; ++j)
+				bits |= static_cast<uint64_t>(bad(base + j)) << j;
+			if (bits != 0)
+				report.MarkWord(base / 64, bits);
+		}
+		return report;
+	}
+
+	// Same checks as the constructors - a record is skipped here exactly when its constructor would throw
+	template <typename T>
+	inline bool BadRadius(T r) {
+		return !CurveChecks::IsRadius(r);
+	}
+
+	template <typename T>
+	inline bool BadFinite(T v) {
+		return !CurveChecks::IsFinite(v);
+	}
+
+	template <typename T>
+	void CheckFloating(const char* what) {
+		if (!std::is_floating_point<T>::value)
+			throw std::logic_error(what);
+	}
+
+}		// namespace BulkDetail
+
+/*********************************** Bulk builders ***************************************/
+
+// Valid curves are appended to `out` in input order; the report tells which records were skipped.
+// Array size mismatch is a caller bug, not bad data - that one still throws
+
+template <typename T>
+BulkReport BuildCircles(const std::vector<T>& rads, std::vector<Circle<T>>& out) {
+	BulkDetail::CheckFloating<T>("Circle coordinate is NOT floating type");
+	const T* r = rads.data();
+	BulkReport report = BulkDetail::Validate(rads.size(), [r](size_t i) {
+		return BulkDetail::BadRadius(r[i]);
+	});
+	out.reserve(out.size() + report.GetValidCount());
+	for (size_t i = 0; i < rads.size(); ++i)
+		if (report.IsValid(i))
+			out.emplace_back(r[i]);
+	return report;
+}
+
+template <typename T>
+BulkReport BuildEllipses(const std::vector<T>& radsX, const std::vector<T>& radsY, std::vector<Ellipsis<T>>& out) {
+	BulkDetail::CheckFloating<T>("Ellipsis coordinate is NOT floating type");
+	if (radsX.size() != radsY.size())
+		throw std::logic_error("Parameter arrays must have equal sizes");
+	const T* rx = radsX.data();
+	const T* ry = radsY.data();
+	BulkReport report = BulkDetail::Validate(radsX.size(), [rx, ry](size_t i) {
+		return BulkDetail::BadRadius(rx[i]) | BulkDetail::BadRadius(ry[i]);
+	});
+	out.reserve(out.size() + report.GetValidCount());
+	for (size_t i = 0; i < radsX.size(); ++i)
+		if (report.IsValid(i))
+			out.emplace_back(rx[i], ry[i]);
+	return report;
+}
+
+template <typename T>
+BulkReport BuildHelices(const std::vector<T>& rads, const std::vector<T>& steps, std::vector<Helix<T>>& out) {
+	BulkDetail::CheckFloating<T>("Helix coordinate is NOT floating type");
+	if (rads.size() != steps.size())
+		throw std::logic_error("Parameter arrays must have equal sizes");
+	const T* r = rads.data();
+	const T* s = steps.data();
+	BulkReport report = BulkDetail::Validate(rads.size(), [r, s](size_t i) {
+		return BulkDetail::BadRadius(r[i]) | BulkDetail::BadFinite(s[i]);
+	});
+	out.reserve(out.size() + report.GetValidCount());
+	for (size_t i = 0; i < rads.size(); ++i)
+		if (report.IsValid(i))
+			out.emplace_back(r[i], s[i]);
+	return report;
+}
@@ -13,9 +13,11 @@ public:				// constructors
 public:				// methods
 	const T GetRad() const;
 	const Point<T> GetPointByParam(T param) const;
+	void GetPointsByParams(const T* params, std::size_t count, T* xs, T* ys, T* zs) const;
 	const TriDvector<T> GetDerivativeByParam(T param) const;
 
 	const bool IsCircle() const;
+	const CurveKind GetKind() const;
 };
 
 /****************************************** DEFINITIONS ************************************************/
@@ -24,7 +26,9 @@ template <typename T>
 Circle<T>::Circle(T rad) : rad_(rad) {
 	if (!std::is_floating_point<T>::value)
 		throw std::logic_error("Circle coordinate is NOT floating type");
-	if (rad <= 0)
+	if (!CurveChecks::IsFinite(rad))
+		throw std::logic_error("Curve parameters must be finite");
+	if (!CurveChecks::IsRadius(rad))
 		throw std::logic_error("Radii must be positive");
 }
 
@@ -35,16 +39,33 @@ const T Circle<T>::GetRad() const {
 
 template <typename T>
 const Point<T> Circle<T>::GetPointByParam(T param) const {
-	T x = rad_ * std::cos(param);
-	T y = rad_ * std::sin(param);
+	CURVES_PROFILE_COUNT(CircleEval);
+	T x, y;
+	{
+		CURVES_PROFILE_FINE_SCOPE("Circle::trig");
+		x = rad_ * std::cos(param);
+		y = rad_ * std::sin(param);
+	}
 	T z = 0;
 
+	CURVES_PROFILE_FINE_SCOPE("Circle::construction");
 	Point<T> ret(x, y, z);
 	return ret;
 }
 
+template <typename T>
+void Circle<T>::GetPointsByParams(const T* params, std::size_t count, T* xs, T* ys, T* zs) const {
+	CURVES_PROFILE_COUNT_N(CircleBatchPoint, count);
+	for (std::size_t i = 0; i < count; ++i) {
+		xs[i] = rad_ * std::cos(params[i]);
+		ys[i] = rad_ * std::sin(params[i]);
+		zs[i] = 0;
+	}
+}
+
 template <typename T>
 const TriDvector<T> Circle<T>::GetDerivativeByParam(T param) const {
+	CURVES_PROFILE_COUNT(CircleDeriv);
 	T x = (-1) * std::sin(param);
 	T y = std::cos(param);
 	T z = 0;
@@ -58,3 +79,8 @@ template<typename T>
 const bool Circle<T>::IsCircle() const {
 	return true;
 }
+
+template<typename T>
+const CurveKind Circle<T>::GetKind() const {
+	return CurveKind::Circle;
+}
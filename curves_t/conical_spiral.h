@@ -0,0 +1,117 @@
+#pragma once
+
+#include "curve.h"
+#include "range_reduction.h"
+
+// Helix on a cone: radius changes by growth every turn while z rises by step.
+// r(t) = rad + t * growth / 2PI, point (r * cos(t), r * sin(t), t * step / 2PI).
+// rad is the radius at t = 0; past r = 0 the spiral goes through the axis and continues on the other side
+template <typename T>
+class ConicalSpiral final : public Curve<T> {
+private:		// fields
+	const T rad_;
+	const T step_;
+	const T growth_;
+	const T step_per_rad_;			// step / (2*PI)
+	const T growth_per_rad_;		// growth / (2*PI)
+
+public:			// constructors
+	ConicalSpiral() = delete;
+	explicit ConicalSpiral(T rad, T step, T growth);
+
+public:			// methods
+	const T GetRad() const;
+	const T GetStep() const;
+	const T GetGrowth() const;
+	const Point<T> GetPointByParam(T param) const;
+	void GetPointsByParams(const T* params, std::size_t count, T* xs, T* ys, T* zs) const;
+	const TriDvector<T> GetDerivativeByParam(T param) const;
+
+	const bool IsCircle() const;
+	const CurveKind GetKind() const;
+};
+
+/****************************************** DEFINITIONS ************************************************/
+
+template <typename T>
+ConicalSpiral<T>::ConicalSpiral(T rad, T step, T growth)
+	: rad_(rad), step_(step), growth_(growth),
+	step_per_rad_(static_cast<T>(step * RangeReduction::INV_TWO_PI)),
+	growth_per_rad_(static_cast<T>(growth * RangeReduction::INV_TWO_PI)) {
+	if (!std::is_floating_point<T>::value)
+		throw std::logic_error("ConicalSpiral coordinate is NOT floating type");
+	if (rad <= 0)
+		throw std::logic_error("Radii must be positive");
+}
+
+template <typename T>
+const T ConicalSpiral<T>::GetRad() const {
+	return rad_;
+}
+
+template <typename T>
+const T ConicalSpiral<T>::GetStep() const {
+	return step_;
+}
+
+template <typename T>
+const T ConicalSpiral<T>::GetGrowth() const {
+	return growth_;
+}
+
+// Radius and z both grow by whole amounts per turn - same split as Helix
+template <typename T>
+const Point<T> ConicalSpiral<T>::GetPointByParam(T param) const {
+	CURVES_PROFILE_COUNT(ConicalSpiralEval);
+	double angle;
+	const double turns = RangeReduction::ReduceTurns(param, angle);
+	const T r = static_cast<T>(rad_ + turns * growth_ + angle * growth_per_rad_);
+	Point<T> ret(
+		r * static_cast<T>(std::cos(angle)),
+		r * static_cast<T>(std::sin(angle)),
+		static_cast<T>(turns * step_ + angle * step_per_rad_)
+	);
+	return ret;
+}
+
+template <typename T>
+void ConicalSpiral<T>::GetPointsByParams(const T* params, std::size_t count, T* xs, T* ys, T* zs) const {
+	CURVES_PROFILE_COUNT_N(ConicalSpiralBatchPoint, count);
+	for (std::size_t i = 0; i < count; ++i) {
+		double angle;
+		const double turns = RangeReduction::ReduceTurns(params[i], angle);
+		xs[i] = static_cast<T>(angle);
+		ys[i] = static_cast<T>(rad_ + turns * growth_ + angle * growth_per_rad_);
+		zs[i] = static_cast<T>(turns * step_ + angle * step_per_rad_);
+	}
+	for (std::size_t i = 0; i < count; ++i) {
+		const T angle = xs[i];
+		const T r = ys[i];
+		xs[i] = r * std::cos(angle);
+		ys[i] = r * std::sin(angle);
+	}
+}
+
+// d/dt (r cos t, r sin t, z) = (r' cos t - r sin t, r' sin t + r cos t, z')
+template <typename T>
+const TriDvector<T> ConicalSpiral<T>::GetDerivativeByParam(T param) const {
+	CURVES_PROFILE_COUNT(ConicalSpiralDeriv);
+	double angle;
+	const double turns = RangeReduction::ReduceTurns(param, angle);
+	const T r = static_cast<T>(rad_ + turns * growth_ + angle * growth_per_rad_);
+	const T c = static_cast<T>(std::cos(angle));
+	const T s = static_cast<T>(std::sin(angle));
+	TriDvector<T> ret(growth_per_rad_ * c - r * s, growth_per_rad_ * s + r * c, step_per_rad_);
+	ret.Normalize();
+	return ret;
+}
+
+template <typename T>
+const bool ConicalSpiral<T>::IsCircle() const {
+	return false;
+}
+
+template <typename T>
+const CurveKind ConicalSpiral<T>::GetKind() const {
+	return CurveKind::ConicalSpiral;
+}
@@ -1,15 +1,49 @@
 #pragma once
 
 #include <cmath>
+#include <cstddef>
+#include <limits>
 
 #include "Point.h"
 #include "3Dvector.h"
+#include "profiler.h"
+
+enum class CurveKind {
+	Unknown,
+	Circle,
+	Ellipsis,
+	Helix,
+	Segment,
+	Arc,
+	EllipticHelix,
+	ConicalSpiral,
+	Bezier,
+	BSpline
+};
+
+// Parameter checks shared by the constructors and the bulk builders, so both accept exactly the same values.
+// Branch-free; NaN fails every comparison, so it's rejected along with the infinities
+namespace CurveChecks {
+
+	template <typename T>
+	inline bool IsFinite(T v) {
+		return (v >= std::numeric_limits<T>::lowest()) & (v <= std::numeric_limits<T>::max());
+	}
+
+	template <typename T>
+	inline bool IsRadius(T r) {
+		return (r > 0) & (r <= std::numeric_limits<T>::max());
+	}
+
+}		// namespace CurveChecks
 
 template <typename T>
 class Curve {
 
 public:
-	
+	// curves are owned through base pointers (unique_ptr<Curve<T>>) - derived parts must be destroyed too
+	virtual ~Curve() = default;
+
 	virtual const Point<T> GetPointByParam(T param) const {
 		return Point<T>(0.0, 0.0, 0.0);
 	}
@@ -18,7 +52,23 @@ public:
 		return TriDvector<T>(0.0, 0.0, 0.0);
 	}
 
+	// Batch evaluation into separate coordinate arrays (structure-of-arrays output).
+	// Default goes point by point, concrete curves override it with tight loops
+	virtual void GetPointsByParams(const T* params, std::size_t count, T* xs, T* ys, T* zs) const {
+		for (std::size_t i = 0; i < count; ++i) {
+			const Point<T> p = GetPointByParam(params[i]);
+			xs[i] = p.GetX();
+			ys[i] = p.GetY();
+			zs[i] = p.GetZ();
+		}
+	}
+
 	virtual const bool IsCircle() const {
 		return false;
 	}
+
+	// lets free algorithms (intersections etc.) dispatch without dynamic_cast
+	virtual const CurveKind GetKind() const {
+		return CurveKind::Unknown;
+	}
 };
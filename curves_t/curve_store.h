@@ -0,0 +1,562 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "curve.h"
+#include "circle.h"
+#include "ellipsis.h"
+#include "helix.h"
+#include "segment.h"
+#include "arc.h"
+#include "elliptic_helix.h"
+#include "conical_spiral.h"
+#include "bezier.h"
+#include "bspline.h"
+
+// Structure-of-arrays curve collection: one kind column, COLUMNS shared parameter columns every kind uses
+// and, for the kinds with wider rows (Segment, Bezier, BSpline), the parameters past COLUMNS in a row-major pool per kind -
+// so circles don't carry twelve columns of spline padding. Rows are up to PARAMS wide, ParamCount(kind) tells how many.
+// Parameter meaning per kind (unused shared columns hold 0):
+//   Circle        - 0: rad
+//   Ellipsis      - 0: radX, 1: radY
+//   Helix         - 0: rad,  1: step
+//   Segment       - 0..2: start xyz, 3..5: end xyz
+//   Arc           - 0: rad,  1: start, 2: sweep
+//   EllipticHelix - 0: radX, 1: radY,  2: step
+//   ConicalSpiral - 0: rad,  1: step,  2: growth
+//   Bezier        - 0..11: control points xyz, one after another
+//   BSpline       - 0..11: de Boor points, same layout
+// Plain arrays can be copied into shared memory or scanned in vectorized passes (GetColumn, ApplyDeltas);
+// parameters stay mutable, so per-frame updates touch the columns instead of rebuilding curve objects;
+// evaluation goes through the very same Circle/Ellipsis/Helix code as Curve<T> objects.
+template <typename T>
+class CurveStore {
+public:				// constants
+	static constexpr size_t PARAMS = 12;			// widest row: Bezier and BSpline control points
+	static constexpr size_t COLUMNS = 3;			// parameters every kind keeps in the shared columns
+
+private:			// constants
+	// Per-row rules for the shared columns: bit c of every group stands for column c
+	static constexpr unsigned USED = 0;							// column is a parameter of the kind
+	static constexpr unsigned POSITIVE = COLUMNS;				// radius - stays > 0
+	static constexpr unsigned NONZERO = 2 * COLUMNS;			// arc sweep - stays != 0
+	static constexpr uint16_t SHAPE = 1 << (3 * COLUMNS);		// constructor compares several parameters (coinciding points)
+
+private:			// fields
+	std::vector<CurveKind> kinds_;
+	std::array<std::vector<T>, COLUMNS> columns_;
+	std::array<std::vector<T>, 3> tails_;			// parameters COLUMNS.. of Segment, Bezier, BSpline rows
+	std::vector<size_t> slots_;						// row inside its kind's tail pool
+	std::vector<uint16_t> rules_;					// RowRules(kind) of every row - ApplyDeltas checks without a switch per element
+	std::vector<SplineDetail::Cubic<T>> bspline_beziers_;	// Bezier form of every BSpline, by slot - kept in sync with the rows
+
+public:				// constructors
+	CurveStore();
+
+	// Unknown curve kinds can't be stored - throws
+	static CurveStore FromCurves(const std::vector<Curve<T>*>& curves);
+
+public:				// methods
+	void AddCircle(T rad);
+	void AddEllipsis(T radX, T radY);
+	void AddHelix(T rad, T step);
+	void AddSegment(const Point<T>& start, const Point<T>& end);
+	void AddArc(T rad, T start, T sweep);
+	void AddEllipticHelix(T radX, T radY, T step);
+	void AddConicalSpiral(T rad, T step, T growth);
+	void AddBezier(const Point<T>& p0, const Point<T>& p1, const Point<T>& p2, const Point<T>& p3);
+	void AddBSpline(const Point<T>& p0, const Point<T>& p1, const Point<T>& p2, const Point<T>& p3);
+
+	const size_t Size() const;
+	const CurveKind GetKind(size_t index) const;
+	const T GetParam(size_t index, size_t column) const;
+	// Fills PARAMS values, zeros past ParamCount of the curve kind
+	void GetRow(size_t index, T* row) const;
+	// Shared columns only: column < COLUMNS, Size() values
+	const T* GetColumn(size_t column) const;
+	const CurveKind* GetKinds() const;
+
+	// Both validate the result like the constructors do and throw leaving the store unchanged
+	void SetParam(size_t index, size_t column, T value);
+	// column[i] += deltas[i] for every curve (deltas holds Size() values, column < PARAMS) - all or nothing.
+	// Curves that don't have the column must get 0. Shared columns go in one branch-free pass;
+	// tail columns (segment ends, spline points) belong to segments and splines only and rebuild every moved row
+	void ApplyDeltas(size_t column, const T* deltas);
+
+	// Materializes one stored curve as an object
+	std::unique_ptr<Curve<T>> MakeCurve(size_t index) const;
+
+	const Point<T> GetPointByParam(size_t index, T param) const;
+	void GetPointsByParams(size_t index, const T* params, size_t count, T* xs, T* ys, T* zs) const;
+	const TriDvector<T> GetDerivativeByParam(size_t index, T param) const;
+
+	// Evaluation from a raw row (kind + PARAMS values) - for copies of the columns living elsewhere
+	static void Evaluate(CurveKind kind, const T* row, const T* params, size_t count, T* xs, T* ys, T* zs);
+	static const TriDvector<T> Derivative(CurveKind kind, const T* row, T param);
+
+	// Builds the curve of the given kind from a row on the stack and calls func(curve).
+	// The single switch over kinds every store path goes through
+	template <typename F>
+	static decltype(auto) Dispatch(CurveKind kind, const T* row, F&& func);
+
+	// Row width of the kind, 0 for unknown kinds
+	static const size_t ParamCount(CurveKind kind);
+
+private:
+	void Push(CurveKind kind, std::initializer_list<T> values);
+	// Builds the curve once to validate - the store accepts exactly what the constructors accept
+	void PushChecked(CurveKind kind, std::initializer_list<T> values);
+	static const Point<T> RowPoint(const T* row, size_t index);
+	// Index into tails_ - only for kinds wider than COLUMNS
+	static const size_t Pool(CurveKind kind);
+	// Converts the stored de Boor points of a BSpline row
+	const SplineDetail::Cubic<T> BezierOf(size_t index) const;
+	static const uint16_t RowRules(CurveKind kind);
+	void CheckRow(size_t index, size_t column, T value) const;
+	T& TailParam(size_t index, size_t column);
+	void ApplyTailDeltas(size_t column, const T* deltas);
+};
+
+/****************************************** DEFINITIONS ************************************************/
+
+template <typename T>
+CurveStore<T>::CurveStore() {
+	if (!std::is_floating_point<T>::value)
+		throw std::logic_error("CurveStore coordinate is NOT floating type");
+}
+
+template <typename T>
+CurveStore<T> CurveStore<T>::FromCurves(const std::vector<Curve<T>*>& curves) {
+	CurveStore<T> ret;
+	for (const Curve<T>* cur : curves) {
+		switch (cur->GetKind()) {
+		case CurveKind::Circle:
+			ret.AddCircle(static_cast<const Circle<T>*>(cur)->GetRad());
+			break;
+		case CurveKind::Ellipsis:
+			ret.AddEllipsis(static_cast<const Ellipsis<T>*>(cur)->GetRadX(), static_cast<const Ellipsis<T>*>(cur)->GetRadY());
+			break;
+		case CurveKind::Helix:
+			ret.AddHelix(static_cast<const Helix<T>*>(cur)->GetRad(), static_cast<const Helix<T>*>(cur)->GetStep());
+			break;
+		case CurveKind::Segment: {
+			const Segment<T>& seg = static_cast<const Segment<T>&>(*cur);
+			ret.AddSegment(seg.GetStart(), seg.GetEnd());
+			break;
+		}
+		case CurveKind::Arc: {
+			const Arc<T>& arc = static_cast<const Arc<T>&>(*cur);
+			ret.AddArc(arc.GetRad(), arc.GetStart(), arc.GetSweep());
+			break;
+		}
+		case CurveKind::EllipticHelix: {
+			const EllipticHelix<T>& eh = static_cast<const EllipticHelix<T>&>(*cur);
+			ret.AddEllipticHelix(eh.GetRadX(), eh.GetRadY(), eh.GetStep());
+			break;
+		}
+		case CurveKind::ConicalSpiral: {
+			const ConicalSpiral<T>& cs = static_cast<const ConicalSpiral<T>&>(*cur);
+			ret.AddConicalSpiral(cs.GetRad(), cs.GetStep(), cs.GetGrowth());
+			break;
+		}
+		case CurveKind::Bezier: {
+			const BezierSegment<T>& bz = static_cast<const BezierSegment<T>&>(*cur);
+			ret.AddBezier(bz.GetControlPoint(0), bz.GetControlPoint(1), bz.GetControlPoint(2), bz.GetControlPoint(3));
+			break;
+		}
+		case CurveKind::BSpline: {
+			const BSplineSegment<T>& bs = static_cast<const BSplineSegment<T>&>(*cur);
+			ret.AddBSpline(bs.GetControlPoint(0), bs.GetControlPoint(1), bs.GetControlPoint(2), bs.GetControlPoint(3));
+			break;
+		}
+		default:
+			throw std::logic_error("Unknown curve kind can't be stored");
+		}
+	}
+	return ret;
+}
+
+template <typename T>
+void CurveStore<T>::AddCircle(T rad) {
+	PushChecked(CurveKind::Circle, { rad });
+}
+
+template <typename T>
+void CurveStore<T>::AddEllipsis(T radX, T radY) {
+	PushChecked(CurveKind::Ellipsis, { radX, radY });
+}
+
+template <typename T>
+void CurveStore<T>::AddHelix(T rad, T step) {
+	PushChecked(CurveKind::Helix, { rad, step });
+}
+
+template <typename T>
+void CurveStore<T>::AddSegment(const Point<T>& start, const Point<T>& end) {
+	PushChecked(CurveKind::Segment, { start.GetX(), start.GetY(), start.GetZ(), end.GetX(), end.GetY(), end.GetZ() });
+}
+
+template <typename T>
+void CurveStore<T>::AddArc(T rad, T start, T sweep) {
+	PushChecked(CurveKind::Arc, { rad, start, sweep });
+}
+
+template <typename T>
+void CurveStore<T>::AddEllipticHelix(T radX, T radY, T step) {
+	PushChecked(CurveKind::EllipticHelix, { radX, radY, step });
+}
+
+template <typename T>
+void CurveStore<T>::AddConicalSpiral(T rad, T step, T growth) {
+	PushChecked(CurveKind::ConicalSpiral, { rad, step, growth });
+}
+
+template <typename T>
+void CurveStore<T>::AddBezier(const Point<T>& p0, const Point<T>& p1, const Point<T>& p2, const Point<T>& p3) {
+	PushChecked(CurveKind::Bezier, {
+		p0.GetX(), p0.GetY(), p0.GetZ(), p1.GetX(), p1.GetY(), p1.GetZ(),
+		p2.GetX(), p2.GetY(), p2.GetZ(), p3.GetX(), p3.GetY(), p3.GetZ() });
+}
+
+template <typename T>
+void CurveStore<T>::AddBSpline(const Point<T>& p0, const Point<T>& p1, const Point<T>& p2, const Point<T>& p3) {
+	PushChecked(CurveKind::BSpline, {
+		p0.GetX(), p0.GetY(), p0.GetZ(), p1.GetX(), p1.GetY(), p1.GetZ(),
+		p2.GetX(), p2.GetY(), p2.GetZ(), p3.GetX(), p3.GetY(), p3.GetZ() });
+}
+
+template <typename T>
+void CurveStore<T>::Push(CurveKind kind, std::initializer_list<T> values) {
+	const size_t width = ParamCount(kind);
+	kinds_.push_back(kind);
+	auto it = values.begin();
+	for (size_t k = 0; k < COLUMNS; ++k)
+		columns_[k].push_back(it != values.end() ? *it++ : T(0));
+	if (width > COLUMNS) {
+		std::vector<T>& tail = tails_[Pool(kind)];
+		slots_.push_back(tail.size() / (width - COLUMNS));
+		tail.insert(tail.end(), it, values.end());
+	}
+	else
+		slots_.push_back(0);
+	rules_.push_back(RowRules(kind));
+	if (kind == CurveKind::BSpline)
+		bspline_beziers_.push_back(BezierOf(Size() - 1));
+}
+
+template <typename T>
+const SplineDetail::Cubic<T> CurveStore<T>::BezierOf(size_t index) const {
+	T row[PARAMS];
+	GetRow(index, row);
+	return BSplineSegment<T>(RowPoint(row, 0), RowPoint(row, 1), RowPoint(row, 2), RowPoint(row, 3)).GetBezier();
+}
+
+template <typename T>
+void CurveStore<T>::PushChecked(CurveKind kind, std::initializer_list<T> values) {
+	T row[PARAMS] = {};
+	std::copy(values.begin(), values.end(), row);
+	Dispatch(kind, row, [](const auto&) {});
+	Push(kind, values);
+}
+
+template <typename T>
+const Point<T> CurveStore<T>::RowPoint(const T* row, size_t index) {
+	return Point<T>(row[3 * index], row[3 * index + 1], row[3 * index + 2]);
+}
+
+template <typename T>
+const size_t CurveStore<T>::ParamCount(CurveKind kind) {
+	switch (kind) {
+	case CurveKind::Circle:
+		return 1;
+	case CurveKind::Ellipsis:
+	case CurveKind::Helix:
+		return 2;
+	case CurveKind::Arc:
+	case CurveKind::EllipticHelix:
+	case CurveKind::ConicalSpiral:
+		return 3;
+	case CurveKind::Segment:
+		return 6;
+	case CurveKind::Bezier:
+	case CurveKind::BSpline:
+		return 12;
+	default:
+		return 0;
+	}
+}
+
+template <typename T>
+const size_t CurveStore<T>::Pool(CurveKind kind) {
+	switch (kind) {
+	case CurveKind::Segment:
+		return 0;
+	case CurveKind::Bezier:
+		return 1;
+	default:
+		return 2;
+	}
+}
+
+template <typename T>
+template <typename F>
+decltype(auto) CurveStore<T>::Dispatch(CurveKind kind, const T* row, F&& func) {
+	switch (kind) {
+	case CurveKind::Circle:
+		return func(Circle<T>(row[0]));
+	case CurveKind::Ellipsis:
+		return func(Ellipsis<T>(row[0], row[1]));
+	case CurveKind::Helix:
+		return func(Helix<T>(row[0], row[1]));
+	case CurveKind::Segment:
+		return func(Segment<T>(RowPoint(row, 0), RowPoint(row, 1)));
+	case CurveKind::Arc:
+		return func(Arc<T>(row[0], row[1], row[2]));
+	case CurveKind::EllipticHelix:
+		return func(EllipticHelix<T>(row[0], row[1], row[2]));
+	case CurveKind::ConicalSpiral:
+		return func(ConicalSpiral<T>(row[0], row[1], row[2]));
+	case CurveKind::Bezier:
+		return func(BezierSegment<T>(RowPoint(row, 0), RowPoint(row, 1), RowPoint(row, 2), RowPoint(row, 3)));
+	case CurveKind::BSpline:
+		return func(BSplineSegment<T>(RowPoint(row, 0), RowPoint(row, 1), RowPoint(row, 2), RowPoint(row, 3)));
+	default:
+		throw std::logic_error("Unknown curve kind in CurveStore");
+	}
+}
+
+template <typename T>
+const size_t CurveStore<T>::Size() const {
+	return kinds_.size();
+}
+
+template <typename T>
+const CurveKind CurveStore<T>::GetKind(size_t index) const {
+	return kinds_[index];
+}
+
+template <typename T>
+const T CurveStore<T>::GetParam(size_t index, size_t column) const {
+	if (column < COLUMNS)
+		return columns_[column][index];
+	const CurveKind kind = kinds_[index];
+	const size_t width = ParamCount(kind);
+	if (column >= width)
+		return T(0);
+	return tails_[Pool(kind)][slots_[index] * (width - COLUMNS) + column - COLUMNS];
+}
+
+template <typename T>
+void CurveStore<T>::GetRow(size_t index, T* row) const {
+	for (size_t k = 0; k < COLUMNS; ++k)
+		row[k] = columns_[k][index];
+	const CurveKind kind = kinds_[index];
+	const size_t width = ParamCount(kind);
+	if (width > COLUMNS) {
+		const T* tail = tails_[Pool(kind)].data() + slots_[index] * (width - COLUMNS);
+		std::copy(tail, tail + width - COLUMNS, row + COLUMNS);
+	}
+	std::fill(row + std::max(width, COLUMNS), row + PARAMS, T(0));
+}
+
+template <typename T>
+const T* CurveStore<T>::GetColumn(size_t column) const {
+	return columns_[column].data();
+}
+
+template <typename T>
+const CurveKind* CurveStore<T>::GetKinds() const {
+	return kinds_.data();
+}
+
+// Mirrors the constructor checks that involve a single shared column
+template <typename T>
+const uint16_t CurveStore<T>::RowRules(CurveKind kind) {
+	const uint16_t used = static_cast<uint16_t>((1u << std::min(ParamCount(kind), COLUMNS)) - 1);
+	switch (kind) {
+	case CurveKind::Circle:
+	case CurveKind::Helix:
+	case CurveKind::ConicalSpiral:
+		return used | (1 << POSITIVE);
+	case CurveKind::Ellipsis:
+	case CurveKind::EllipticHelix:
+		return used | (3 << POSITIVE);
+	case CurveKind::Arc:
+		return used | (1 << POSITIVE) | (4 << NONZERO);
+	default:
+		return used | SHAPE;
+	}
+}
+
+// Runs the constructor of the row with one value replaced
+template <typename T>
+void CurveStore<T>::CheckRow(size_t index, size_t column, T value) const {
+	T row[PARAMS];
+	GetRow(index, row);
+	row[column] = value;
+	Dispatch(kinds_[index], row, [](const auto&) {});
+}
+
+template <typename T>
+T& CurveStore<T>::TailParam(size_t index, size_t column) {
+	const CurveKind kind = kinds_[index];
+	return tails_[Pool(kind)][slots_[index] * (ParamCount(kind) - COLUMNS) + column - COLUMNS];
+}
+
+template <typename T>
+void CurveStore<T>::SetParam(size_t index, size_t column, T value) {
+	if (index >= Size() || column >= PARAMS)
+		throw std::logic_error("CurveStore index out of range");
+	const CurveKind kind = kinds_[index];
+	const size_t width = ParamCount(kind);
+	if (column >= width)
+		throw std::logic_error("Column is not a parameter of this curve kind");
+	if (!std::isfinite(value))
+		throw std::logic_error("Curve parameters must be finite");
+	CheckRow(index, column, value);
+	if (column < COLUMNS)
+		columns_[column][index] = value;
+	else
+		TailParam(index, column) = value;
+	if (kind == CurveKind::BSpline)
+		bspline_beziers_[slots_[index]] = BezierOf(index);
+}
+
+template <typename T>
+void CurveStore<T>::ApplyDeltas(size_t column, const T* deltas) {
+	if (column >= PARAMS)
+		throw std::logic_error("CurveStore index out of range");
+	if (column >= COLUMNS) {
+		ApplyTailDeltas(column, deltas);
+		return;
+	}
+	const size_t n = Size();
+	T* cur = columns_[column].data();
+	const uint16_t* rules = rules_.data();
+	const uint16_t used_bit = static_cast<uint16_t>(1 << (USED + column));
+	const uint16_t positive_bit = static_cast<uint16_t>(1 << (POSITIVE + column));
+	const uint16_t nonzero_bit = static_cast<uint16_t>(1 << (NONZERO + column));
+
+	// branch-free checks over the whole column before anything is written
+	bool used = true;
+	bool finite = true;
+	bool positive = true;
+	bool nonzero = true;
+	bool shaped = false;
+	for (size_t i = 0; i < n; ++i) {
+		const T next = cur[i] + deltas[i];
+		const bool moved = deltas[i] != 0;
+		used &= (rules[i] & used_bit) != 0 || !moved;
+		finite &= std::isfinite(next);
+		positive &= (rules[i] & positive_bit) == 0 || next > 0;
+		nonzero &= (rules[i] & nonzero_bit) == 0 || next != 0;
+		shaped |= (rules[i] & SHAPE) != 0 && moved;
+	}
+	if (!used)
+		throw std::logic_error("Column is not a parameter of this curve kind");
+	if (!finite)
+		throw std::logic_error("Curve parameters must be finite");
+	if (!positive)
+		throw std::logic_error("Radii must be positive");
+	if (!nonzero)
+		throw std::logic_error("Arc sweep must be non-zero");
+	// moved points of segments and splines - only these need the whole row
+	if (shaped)
+		for (size_t i = 0; i < n; ++i)
+			if ((rules[i] & SHAPE) && deltas[i] != 0)
+				CheckRow(i, column, cur[i] + deltas[i]);
+
+	for (size_t i = 0; i < n; ++i)
+		cur[i] += deltas[i];				// in place - GetColumn() pointers stay valid
+	if (shaped)
+		for (size_t i = 0; i < n; ++i)
+			if (kinds_[i] == CurveKind::BSpline && deltas[i] != 0)
+				bspline_beziers_[slots_[i]] = BezierOf(i);
+}
+
+// Only shape-checked kinds have tail columns, so every moved row runs its constructor anyway - no column pass to win
+template <typename T>
+void CurveStore<T>::ApplyTailDeltas(size_t column, const T* deltas) {
+	const size_t n = Size();
+	for (size_t i = 0; i < n; ++i)
+		if (deltas[i] != 0 && column >= ParamCount(kinds_[i]))
+			throw std::logic_error("Column is not a parameter of this curve kind");
+	for (size_t i = 0; i < n; ++i)
+		if (deltas[i] != 0 && !std::isfinite(TailParam(i, column) + deltas[i]))
+			throw std::logic_error("Curve parameters must be finite");
+	for (size_t i = 0; i < n; ++i)
+		if (deltas[i] != 0)
+			CheckRow(i, column, TailParam(i, column) + deltas[i]);
+
+	for (size_t i = 0; i < n; ++i) {
+		if (deltas[i] == 0)
+			continue;
+		TailParam(i, column) += deltas[i];
+		if (kinds_[i] == CurveKind::BSpline)
+			bspline_beziers_[slots_[i]] = BezierOf(i);
+	}
+}
+
+template <typename T>
+std::unique_ptr<Curve<T>> CurveStore<T>::MakeCurve(size_t index) const {
+	T row[PARAMS];
+	GetRow(index, row);
+	return Dispatch(kinds_[index], row, [](const auto& c) -> std::unique_ptr<Curve<T>> {
+		return std::make_unique<std::decay_t<decltype(c)>>(c);
+	});
+}
+
+template <typename T>
+const Point<T> CurveStore<T>::GetPointByParam(size_t index, T param) const {
+	T x, y, z;
+	GetPointsByParams(index, &param, 1, &x, &y, &z);
+	return Point<T>(x, y, z);
+}
+
+// BSplines run on the cached Bezier form; the other kinds are cheap to build from the row
+template <typename T>
+void CurveStore<T>::GetPointsByParams(size_t index, const T* params, size_t count, T* xs, T* ys, T* zs) const {
+	if (kinds_[index] == CurveKind::BSpline) {
+		CURVES_PROFILE_COUNT_N(BSplineBatchPoint, count);
+		bspline_beziers_[slots_[index]].GetPoints(params, count, xs, ys, zs);
+		return;
+	}
+	T row[PARAMS];
+	GetRow(index, row);
+	Evaluate(kinds_[index], row, params, count, xs, ys, zs);
+}
+
+// Stack-constructed curve per call: no allocation, exactly the Curve<T> evaluation semantics
+template <typename T>
+void CurveStore<T>::Evaluate(CurveKind kind, const T* row, const T* params, size_t count, T* xs, T* ys, T* zs) {
+	Dispatch(kind, row, [&](const auto& c) {
+		c.GetPointsByParams(params, count, xs, ys, zs);
+	});
+}
+
+template <typename T>
+const TriDvector<T> CurveStore<T>::GetDerivativeByParam(size_t index, T param) const {
+	if (kinds_[index] == CurveKind::BSpline) {
+		CURVES_PROFILE_COUNT(BSplineDeriv);
+		return bspline_beziers_[slots_[index]].GetTangent(param);
+	}
+	T row[PARAMS];
+	GetRow(index, row);
+	return Derivative(kinds_[index], row, param);
+}
+
+template <typename T>
+const TriDvector<T> CurveStore<T>::Derivative(CurveKind kind, const T* row, T param) {
+	return Dispatch(kind, row, [param](const auto& c) {
+		return c.GetDerivativeByParam(param);
+	});
+}
@@ -15,9 +15,11 @@ public:				// methods
 	const T GetRadX() const;
 	const T GetRadY() const;
 	const Point<T> GetPointByParam(T param) const;
+	void GetPointsByParams(const T* params, std::size_t count, T* xs, T* ys, T* zs) const;
 	const TriDvector<T> GetDerivativeByParam(double param) const;
 
 	const bool IsCircle() const;
+	const CurveKind GetKind() const;
 };
 
 /****************************************** DEFINITIONS ************************************************/
@@ -26,7 +28,9 @@ template<typename T>
 Ellipsis<T>::Ellipsis(T radX, T radY) : radX_(radX), radY_(radY) {
 	if (!std::is_floating_point<T>::value)
 		throw std::logic_error("Ellipsis coordinate is NOT floating type");
-	if (radX <= 0 || radY <= 0)
+	if (!CurveChecks::IsFinite(radX) || !CurveChecks::IsFinite(radY))
+		throw std::logic_error("Curve parameters must be finite");
+	if (!CurveChecks::IsRadius(radX) || !CurveChecks::IsRadius(radY))
 		throw std::logic_error("Radii must be positive");
 }
 
@@ -42,16 +46,33 @@ const T Ellipsis<T>::GetRadY() const {
 
 template<typename T>
 const Point<T> Ellipsis<T>::GetPointByParam(T param) const {
-	T x = radX_ * std::cos(param);
-	T y = radY_ * std::sin(param);
+	CURVES_PROFILE_COUNT(EllipsisEval);
+	T x, y;
+	{
+		CURVES_PROFILE_FINE_SCOPE("Ellipsis::trig");
+		x = radX_ * std::cos(param);
+		y = radY_ * std::sin(param);
+	}
 	T z = 0;
 
+	CURVES_PROFILE_FINE_SCOPE("Ellipsis::construction");
 	Point<T> ret(x, y, z);
 	return ret;
 }
 
+template<typename T>
+void Ellipsis<T>::GetPointsByParams(const T* params, std::size_t count, T* xs, T* ys, T* zs) const {
+	CURVES_PROFILE_COUNT_N(EllipsisBatchPoint, count);
+	for (std::size_t i = 0; i < count; ++i) {
+		xs[i] = radX_ * std::cos(params[i]);
+		ys[i] = radY_ * std::sin(params[i]);
+		zs[i] = 0;
+	}
+}
+
 template<typename T>
 const TriDvector<T> Ellipsis<T>::GetDerivativeByParam(double param) const {
+	CURVES_PROFILE_COUNT(EllipsisDeriv);
 	T x = (-1) * radX_ * std::sin(param);
 	T y = radY_ * std::cos(param);
 	T z = 0;
@@ -65,3 +86,8 @@ template<typename T>
 const bool Ellipsis<T>::IsCircle() const {
 	return false;
 }
+
+template<typename T>
+const CurveKind Ellipsis<T>::GetKind() const {
+	return CurveKind::Ellipsis;
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "curve.h"
+#include "range_reduction.h"
+
+// Helix over an ellipse: (radX * cos(t), radY * sin(t), t * step / 2PI).
+// Same range reduction as Helix, so deep parameters keep their precision
+template <typename T>
+class EllipticHelix final : public Curve<T> {
+private:		// fields
+	const T radX_;
+	const T radY_;
+	const T step_;
+	const T step_per_rad_;			// step / (2*PI) - z growth per radian
+
+public:			// constructors
+	EllipticHelix() = delete;
+	explicit EllipticHelix(T radX, T radY, T step);
+
+public:			// methods
+	const T GetRadX() const;
+	const T GetRadY() const;
+	const T GetStep() const;
+	const Point<T> GetPointByParam(T param) const;
+	void GetPointsByParams(const T* params, std::size_t count, T* xs, T* ys, T* zs) const;
+	const TriDvector<T> GetDerivativeByParam(T param) const;
+
+	const bool IsCircle() const;
+	const CurveKind GetKind() const;
+};
+
+/****************************************** DEFINITIONS ************************************************/
+
+template <typename T>
+EllipticHelix<T>::EllipticHelix(T radX, T radY, T step)
+	: radX_(radX), radY_(radY), step_(step), step_per_rad_(static_cast<T>(step * RangeReduction::INV_TWO_PI)) {
+	if (!std::is_floating_point<T>::value)
+		throw std::logic_error("EllipticHelix coordinate is NOT floating type");
+	if (radX <= 0 || radY <= 0)
+		throw std::logic_error("Radii must be positive");
+}
+
+template <typename T>
+const T EllipticHelix<T>::GetRadX() const {
+	return radX_;
+}
+
+template <typename T>
+const T EllipticHelix<T>::GetRadY() const {
+	return radY_;
+}
+
+template <typename T>
+const T EllipticHelix<T>::GetStep() const {
+	return step_;
+}
+
+template <typename T>
+const Point<T> EllipticHelix<T>::GetPointByParam(T param) const {
+	CURVES_PROFILE_COUNT(EllipticHelixEval);
+	double angle;
+	const double turns = RangeReduction::ReduceTurns(param, angle);
+	Point<T> ret(
+		radX_ * static_cast<T>(std::cos(angle)),
+		radY_ * static_cast<T>(std::sin(angle)),
+		static_cast<T>(turns * step_ + angle * step_per_rad_)
+	);
+	return ret;
+}
+
+// Two passes as in Helix: range reduction, then trig on small angles
+template <typename T>
+void EllipticHelix<T>::GetPointsByParams(const T* params, std::size_t count, T* xs, T* ys, T* zs) const {
+	CURVES_PROFILE_COUNT_N(EllipticHelixBatchPoint, count);
+	for (std::size_t i = 0; i < count; ++i) {
+		double angle;
+		const double turns = RangeReduction::ReduceTurns(params[i], angle);
+		xs[i] = static_cast<T>(angle);
+		zs[i] = static_cast<T>(turns * step_ + angle * step_per_rad_);
+	}
+	for (std::size_t i = 0; i < count; ++i) {
+		const T angle = xs[i];
+		xs[i] = radX_ * std::cos(angle);
+		ys[i] = radY_ * std::sin(angle);
+	}
+}
+
+template <typename T>
+const TriDvector<T> EllipticHelix<T>::GetDerivativeByParam(T param) const {
+	CURVES_PROFILE_COUNT(EllipticHelixDeriv);
+	double angle;
+	RangeReduction::ReduceTurns(param, angle);
+	TriDvector<T> ret(
+		-radX_ * static_cast<T>(std::sin(angle)),
+		radY_ * static_cast<T>(std::cos(angle)),
+		step_per_rad_
+	);
+	ret.Normalize();
+	return ret;
+}
+
+template <typename T>
+const bool EllipticHelix<T>::IsCircle() const {
+	return false;
+}
+
+template <typename T>
+const CurveKind EllipticHelix<T>::GetKind() const {
+	return CurveKind::EllipticHelix;
+}
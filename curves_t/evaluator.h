@@ -0,0 +1,121 @@
+#pragma once
+
+#include <cmath>
+
+#include "curve.h"
+#include "circle.h"
+#include "ellipsis.h"
+#include "helix.h"
+#include "range_reduction.h"
+
+// Low-latency single point evaluators for the real-time path.
+// Built once per curve, they keep every per-call constant precomputed (step / 2PI, tangent norms),
+// never allocate, never throw and don't construct Point / TriDvector - results go to plain out-params.
+// Results match GetPointByParam / GetDerivativeByParam; tangents are computed in full precision,
+// while TriDvector::Normalize() goes through float powf/sqrtf, so they differ from it by ~1e-7.
+
+template <typename T>
+class CircleEvaluator {
+private:			// fields
+	T rad_ = 0;
+
+public:				// constructors
+	CircleEvaluator() = default;
+	explicit CircleEvaluator(const Circle<T>& c) noexcept : rad_(c.GetRad()) {}
+
+public:				// methods
+	void GetPoint(T param, T& x, T& y, T& z) const noexcept {
+		x = rad_ * std::cos(param);
+		y = rad_ * std::sin(param);
+		z = 0;
+	}
+
+	// (-sin, cos, 0) is already unit length
+	void GetTangent(T param, T& x, T& y, T& z) const noexcept {
+		x = -std::sin(param);
+		y = std::cos(param);
+		z = 0;
+	}
+};
+
+template <typename T>
+class EllipsisEvaluator {
+private:			// fields
+	T radX_ = 0;
+	T radY_ = 0;
+
+public:				// constructors
+	EllipsisEvaluator() = default;
+	explicit EllipsisEvaluator(const Ellipsis<T>& e) noexcept : radX_(e.GetRadX()), radY_(e.GetRadY()) {}
+
+public:				// methods
+	void GetPoint(T param, T& x, T& y, T& z) const noexcept {
+		x = radX_ * std::cos(param);
+		y = radY_ * std::sin(param);
+		z = 0;
+	}
+
+	// tangent length changes along the ellipse - one sqrt, no temporaries
+	void GetTangent(T param, T& x, T& y, T& z) const noexcept {
+		const T dx = -radX_ * std::sin(param);
+		const T dy = radY_ * std::cos(param);
+		const T inv = 1 / std::sqrt(dx * dx + dy * dy);
+		x = dx * inv;
+		y = dy * inv;
+		z = 0;
+	}
+};
+
+template <typename T>
+class HelixEvaluator {
+private:			// fields
+	T rad_ = 0;
+	T step_ = 0;
+	T step_per_rad_ = 0;			// step / 2PI
+	T tangent_inv_norm_ = 0;		// 1 / |(-sin, cos, tz)| - constant along the helix
+	T tangent_z_ = 0;				// tz / |(-sin, cos, tz)|
+
+public:				// constructors
+	HelixEvaluator() = default;
+	explicit HelixEvaluator(const Helix<T>& h) noexcept
+		: rad_(h.GetRad()), step_(h.GetStep()), step_per_rad_(static_cast<T>(h.GetStep() * RangeReduction::INV_TWO_PI)) {
+		// same (unnormalized) tangent as Helix::GetDerivativeByParam
+		const T tz = static_cast<T>(step_ * (RangeReduction::TWO_PI / rad_));
+		tangent_inv_norm_ = 1 / std::sqrt(1 + tz * tz);
+		tangent_z_ = tz * tangent_inv_norm_;
+	}
+
+public:				// methods
+	void GetPoint(T param, T& x, T& y, T& z) const noexcept {
+		double angle;
+		const double turns = RangeReduction::ReduceTurns(param, angle);
+		x = rad_ * static_cast<T>(std::cos(angle));
+		y = rad_ * static_cast<T>(std::sin(angle));
+		z = static_cast<T>(turns * step_ + angle * step_per_rad_);
+	}
+
+	void GetTangent(T param, T& x, T& y, T& z) const noexcept {
+		double angle;
+		RangeReduction::ReduceTurns(param, angle);
+		x = static_cast<T>(-std::sin(angle)) * tangent_inv_norm_;
+		y = static_cast<T>(std::cos(angle)) * tangent_inv_norm_;
+		z = tangent_z_;
+	}
+};
+
+/*********************************** Out-of-class fuctions ***************************************/
+
+template <typename T>
+CircleEvaluator<T> MakeEvaluator(const Circle<T>& c) {
+	return CircleEvaluator<T>(c);
+}
+
+template <typename T>
+EllipsisEvaluator<T> MakeEvaluator(const Ellipsis<T>& e) {
+	return EllipsisEvaluator<T>(e);
+}
+
+template <typename T>
+HelixEvaluator<T> MakeEvaluator(const Helix<T>& h) {
+	return HelixEvaluator<T>(h);
+}
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <ranges>
+#include <stdexcept>
+#include <vector>
+
+#include "curve.h"
+
+// Lazy sampling of a curve in fixed-size chunks.
+// `count` points evenly spread over [t0, t1] (both ends included) are produced chunk by chunk
+// into a single reused buffer, so a pipeline of views on top of it keeps constant memory
+// and evaluates only when the sink pulls the next chunk.
+template <typename T>
+class PointChunks : public std::ranges::view_interface<PointChunks<T>> {
+private:			// fields
+	const Curve<T>* curve_ = nullptr;
+	T t0_ = 0;
+	T step_ = 0;
+	size_t count_ = 0;
+	size_t chunk_ = 1;
+
+public:				// types
+	class Iterator {
+	private:		// fields
+		const PointChunks* owner_ = nullptr;
+		size_t next_ = 0;						// index of the first point of the next chunk
+		std::vector<Point<T>> buffer_;
+		bool done_ = true;
+
+	public:			// types
+		using value_type = std::vector<Point<T>>;
+		using difference_type = std::ptrdiff_t;
+		using iterator_concept = std::input_iterator_tag;
+
+	public:			// constructors
+		Iterator() = default;
+		explicit Iterator(const PointChunks* owner) : owner_(owner), done_(false) {
+			buffer_.reserve(owner_->chunk_);
+			Fill();
+		}
+
+	public:			// methods
+		const std::vector<Point<T>>& operator*() const {
+			return buffer_;
+		}
+
+		Iterator& operator++() {
+			Fill();
+			return *this;
+		}
+
+		void operator++(int) {
+			Fill();
+		}
+
+		friend bool operator==(const Iterator& it, std::default_sentinel_t) {
+			return it.done_;
+		}
+
+	private:
+		void Fill() {
+			if (next_ >= owner_->count_) {
+				done_ = true;
+				return;
+			}
+			buffer_.clear();			// keeps capacity - no reallocation after the first chunk
+			const size_t end = std::min(next_ + owner_->chunk_, owner_->count_);
+			for (; next_ < end; ++next_)
+				buffer_.push_back(owner_->curve_->GetPointByParam(owner_->t0_ + owner_->step_ * static_cast<T>(next_)));
+		}
+	};
+
+public:				// constructors
+	PointChunks() = default;
+	PointChunks(const Curve<T>& curve, T t0, T t1, size_t count, size_t chunk);
+
+public:				// methods
+	Iterator begin() const;
+	std::default_sentinel_t end() const;
+
+	const size_t GetCount() const;
+	const size_t GetChunkSize() const;
+};
+
+/****************************************** DEFINITIONS ************************************************/
+
+template <typename T>
+PointChunks<T>::PointChunks(const Curve<T>& curve, T t0, T t1, size_t count, size_t chunk)
+	: curve_(&curve), t0_(t0), step_(count > 1 ? (t1 - t0) / static_cast<T>(count - 1) : 0), count_(count), chunk_(chunk) {
+	if (!std::is_floating_point<T>::value)
+		throw std::logic_error("PointChunks coordinate is NOT floating type");
+	if (chunk == 0)
+		throw std::logic_error("Chunk size must be positive");
+}
+
+template <typename T>
+typename PointChunks<T>::Iterator PointChunks<T>::begin() const {
+	return Iterator(this);
+}
+
+template <typename T>
+std::default_sentinel_t PointChunks<T>::end() const {
+	return std::default_sentinel;
+}
+
+template <typename T>
+const size_t PointChunks<T>::GetCount() const {
+	return count_;
+}
+
+template <typename T>
+const size_t PointChunks<T>::GetChunkSize() const {
+	return chunk_;
+}
+
+/*********************************** Out-of-class fuctions ***************************************/
+
+template <typename T>
+PointChunks<T> SampleChunks(const Curve<T>& curve, T t0, T t1, size_t count, size_t chunk = 1024) {
+	return PointChunks<T>(curve, t0, t1, count, chunk);
+}
+
+// Same samples flattened to single points - still lazy, still one chunk buffer alive
+template <typename T>
+auto SamplePoints(const Curve<T>& curve, T t0, T t1, size_t count, size_t chunk = 1024) {
+	return PointChunks<T>(curve, t0, t1, count, chunk) | std::views::join;
+}
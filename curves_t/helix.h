@@ -1,12 +1,14 @@
 #pragma once
 
 #include "curve.h"
+#include "range_reduction.h"
 
 template <typename T>
 class Helix final : public Curve<T> {
 private:		// fields
 	const T rad_;
 	const T step_;
+	const T step_per_rad_;			// step / (2*PI) - z growth per radian
 
 public:			// constructors
 	Helix() = delete;
@@ -14,19 +16,25 @@ public:			// constructors
 
 public:			// methods
 	const T GetRad() const;
+	const T GetStep() const;
 	const Point<T> GetPointByParam(T param) const;
+	void GetPointsByParams(const T* params, std::size_t count, T* xs, T* ys, T* zs) const;
 	const TriDvector<T> GetDerivativeByParam(double param) const;
 
 	const bool IsCircle() const;
+	const CurveKind GetKind() const;
 };
 
 /****************************************** DEFINITIONS ************************************************/
 
 template<typename T>
-Helix<T>::Helix(T rad, T step) : rad_(rad), step_(step) {
+Helix<T>::Helix(T rad, T step)
+	: rad_(rad), step_(step), step_per_rad_(static_cast<T>(step * RangeReduction::INV_TWO_PI)) {
 	if (!std::is_floating_point<T>::value)
 		throw std::logic_error("Helix coordinate is NOT floating type");
-	if (rad <= 0)
+	if (!CurveChecks::IsFinite(rad) || !CurveChecks::IsFinite(step))
+		throw std::logic_error("Curve parameters must be finite");
+	if (!CurveChecks::IsRadius(rad))
 		throw std::logic_error("Radii must be positive");
 }
 
@@ -35,27 +43,58 @@ const T Helix<T>::GetRad() const {
 	return rad_;
 }
 
+template<typename T>
+const T Helix<T>::GetStep() const {
+	return step_;
+}
+
+// param = turns * 2*PI + angle: trig gets a small argument, z grows by whole steps per turn,
+// so helices with thousands of turns stay precise and off libm's slow path
 template<typename T>
 const Point<T> Helix<T>::GetPointByParam(T param) const {
-	double PI = 3.14159265358979323846;
-	T PI_t = static_cast<T>(PI);
+	CURVES_PROFILE_COUNT(HelixEval);
+	double angle;
+	const double turns = RangeReduction::ReduceTurns(param, angle);
 
-	T x = rad_ * std::cos(param);
-	T y = rad_ * std::sin(param);
-	T z = (param / (2 * PI_t) ) * step_;
+	T x, y;
+	{
+		CURVES_PROFILE_FINE_SCOPE("Helix::trig");
+		x = rad_ * static_cast<T>(std::cos(angle));
+		y = rad_ * static_cast<T>(std::sin(angle));
+	}
+	T z = static_cast<T>(turns * step_ + angle * step_per_rad_);
 
+	CURVES_PROFILE_FINE_SCOPE("Helix::construction");
 	Point<T> ret(x, y, z);
 	return ret;
 }
 
+// Two passes: range reduction first (branch-free, vectorizes), then trig on small angles
+template<typename T>
+void Helix<T>::GetPointsByParams(const T* params, std::size_t count, T* xs, T* ys, T* zs) const {
+	CURVES_PROFILE_COUNT_N(HelixBatchPoint, count);
+	for (std::size_t i = 0; i < count; ++i) {
+		double angle;
+		const double turns = RangeReduction::ReduceTurns(params[i], angle);
+		xs[i] = static_cast<T>(angle);
+		zs[i] = static_cast<T>(turns * step_ + angle * step_per_rad_);
+	}
+	for (std::size_t i = 0; i < count; ++i) {
+		const T angle = xs[i];
+		xs[i] = rad_ * std::cos(angle);
+		ys[i] = rad_ * std::sin(angle);
+	}
+}
+
 template<typename T>
 const TriDvector<T> Helix<T>::GetDerivativeByParam(double param) const {
-	double PI = 3.14159265358979323846;
-	T PI_t = static_cast<T>(PI);
+	CURVES_PROFILE_COUNT(HelixDeriv);
+	double angle;
+	RangeReduction::ReduceTurns(param, angle);
 	
-	T x = (-1) * std::sin(param);
-	T y = std::cos(param);
-	T z = step_* (2 * PI_t / rad_);		// not sure about it
+	T x = (-1) * std::sin(angle);
+	T y = std::cos(angle);
+	T z = static_cast<T>(step_ * (RangeReduction::TWO_PI / rad_));		// not sure about it
 
 	TriDvector<T> ret(x, y, z);
 	ret.Normalize();
@@ -66,3 +105,8 @@ template<typename T>
 const bool Helix<T>::IsCircle() const {
 	return false;
 }
+
+template<typename T>
+const CurveKind Helix<T>::GetKind() const {
+	return CurveKind::Helix;
+}
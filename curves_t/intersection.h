@@ -0,0 +1,453 @@
+#pragma once
+
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <execution>
+#include <limits>
+#include <cmath>
+
+#include "curve.h"
+#include "circle.h"
+#include "ellipsis.h"
+#include "helix.h"
+
+// Plane given by { p : dot(normal, p) == offset }
+template <typename T>
+class Plane {
+private:			// fields
+	const T nx_ = 0;
+	const T ny_ = 0;
+	const T nz_ = 0;
+	const T offset_ = 0;
+
+public:				// constructors
+	Plane() = delete;
+	Plane(T nx, T ny, T nz, T offset);
+
+public:				// methods
+	const T GetNX() const;
+	const T GetNY() const;
+	const T GetNZ() const;
+	const T GetOffset() const;
+
+	// signed (not normalized) distance: dot(normal, p) - offset
+	const T Eval(const Point<T>& p) const;
+};
+
+/****************************************** DEFINITIONS ************************************************/
+
+template <typename T>
+Plane<T>::Plane(T nx, T ny, T nz, T offset) : nx_(nx), ny_(ny), nz_(nz), offset_(offset) {
+	if (!std::is_floating_point<T>::value)
+		throw std::logic_error("Plane coordinate is NOT floating type");
+	if (nx == 0 && ny == 0 && nz == 0)
+		throw std::logic_error("Plane normal must be non-zero");
+}
+
+template <typename T>
+const T Plane<T>::GetNX() const {
+	return nx_;
+}
+
+template <typename T>
+const T Plane<T>::GetNY() const {
+	return ny_;
+}
+
+template <typename T>
+const T Plane<T>::GetNZ() const {
+	return nz_;
+}
+
+template <typename T>
+const T Plane<T>::GetOffset() const {
+	return offset_;
+}
+
+template <typename T>
+const T Plane<T>::Eval(const Point<T>& p) const {
+	return nx_ * p.GetX() + ny_ * p.GetY() + nz_ * p.GetZ() - offset_;
+}
+
+/*********************************** Implementation details ***************************************/
+
+namespace IntersectionDetail {
+
+	constexpr double PI = 3.14159265358979323846;
+
+	// Tolerance the same as AlmostEqual() uses for points
+	template <typename T>
+	constexpr T Tolerance() {
+		return static_cast<T>(1e-6);
+	}
+
+	// Adds base + 2*PI*k for every k that hits [t0, t1]
+	template <typename T>
+	void AddPeriodic(T base, T t0, T t1, std::vector<T>& out) {
+		const T period = static_cast<T>(2 * PI);
+		T k = std::ceil((t0 - base) / period);
+		for (T t = base + k * period; t <= t1; t += period)
+			out.push_back(t);
+	}
+
+	template <typename T>
+	void SortUnique(std::vector<T>& ts) {
+		std::sort(ts.begin(), ts.end());
+		ts.erase(std::unique(ts.begin(), ts.end(),
+			[](T a, T b) { return std::fabs(a - b) < Tolerance<T>(); }), ts.end());
+	}
+
+	// Roots of A*cos(t) + B*sin(t) == C over [t0, t1]. Tangent contact gives a single root
+	template <typename T>
+	std::vector<T> SolveHarmonic(T A, T B, T C, T t0, T t1) {
+		std::vector<T> ret;
+		const T R = std::hypot(A, B);
+		if (R < Tolerance<T>())			// plane is parallel to the curve plane - none or whole curve, report none
+			return ret;
+		T ratio = C / R;
+		if (std::fabs(ratio) > 1 + Tolerance<T>())
+			return ret;
+		ratio = std::clamp(ratio, static_cast<T>(-1), static_cast<T>(1));
+		const T phase = std::atan2(B, A);
+		const T delta = std::acos(ratio);
+		AddPeriodic(phase + delta, t0, t1, ret);
+		if (delta > Tolerance<T>())
+			AddPeriodic(phase - delta, t0, t1, ret);
+		SortUnique(ret);
+		return ret;
+	}
+
+	// Safeguarded Newton on [a, b] where f(a) and f(b) have different signs
+	template <typename T, typename F, typename DF>
+	T NewtonBisect(const F& f, const DF& df, T a, T b) {
+		T fa = f(a);
+		T t = (a + b) / 2;
+		for (int i = 0; i < 100; ++i) {
+			const T ft = f(t);
+			if (std::fabs(ft) < Tolerance<T>() * Tolerance<T>())
+				break;
+			if ((ft < 0) == (fa < 0)) {
+				a = t;
+				fa = ft;
+			}
+			else {
+				b = t;
+			}
+			const T d = df(t);
+			T next = (d != 0) ? t - ft / d : a - 1;
+			if (next <= a || next >= b)			// Newton left the bracket - bisect
+				next = (a + b) / 2;
+			if (std::fabs(next - t) < std::numeric_limits<T>::epsilon() * (1 + std::fabs(t)))
+				return next;
+			t = next;
+		}
+		return t;
+	}
+
+	struct Box {
+		double lo[3];
+		double hi[3];
+	};
+
+	inline bool Overlap(const Box& a, const Box& b) {
+		for (int i = 0; i < 3; ++i)
+			if (a.hi[i] < b.lo[i] || b.hi[i] < a.lo[i])
+				return false;
+		return true;
+	}
+
+	// BVH over uniform parameter segments of one curve
+	template <typename T>
+	class SegmentBVH {
+	public:			// types
+		struct Node {
+			Box box;
+			int left = -1;
+			int right = -1;
+			int seg = -1;			// leaf only
+		};
+
+	private:		// fields
+		std::vector<Node> nodes_;
+		std::vector<Box> seg_boxes_;
+		T t0_;
+		T h_;
+
+	public:			// constructors
+		SegmentBVH() = delete;
+		SegmentBVH(const Curve<T>& c, T t0, T t1, int segments) : t0_(t0), h_((t1 - t0) / segments) {
+			seg_boxes_.reserve(segments);
+			for (int s = 0; s < segments; ++s) {
+				const Point<T> p0 = c.GetPointByParam(t0_ + h_ * s);
+				const Point<T> pm = c.GetPointByParam(t0_ + h_ * (s + static_cast<T>(0.5)));
+				const Point<T> p1 = c.GetPointByParam(t0_ + h_ * (s + 1));
+				// Samples miss the bulge of the arc between them: inflate by a quarter of the chord
+				const double pad = 0.25 * (Distance(p0, pm) + Distance(pm, p1)) + Tolerance<T>();
+				Box b;
+				const Point<T>* ps[3] = { &p0, &pm, &p1 };
+				for (int k = 0; k < 3; ++k) {
+					b.lo[k] = std::numeric_limits<double>::max();
+					b.hi[k] = std::numeric_limits<double>::lowest();
+					for (const Point<T>* p : ps) {
+						const double v = k == 0 ? p->GetX() : (k == 1 ? p->GetY() : p->GetZ());
+						b.lo[k] = std::min(b.lo[k], v - pad);
+						b.hi[k] = std::max(b.hi[k], v + pad);
+					}
+				}
+				seg_boxes_.push_back(b);
+			}
+			nodes_.reserve(2 * segments);
+			Build(0, segments);
+		}
+
+	public:			// methods
+		const std::vector<Node>& GetNodes() const { return nodes_; }
+		const T SegmentBegin(int seg) const { return t0_ + h_ * seg; }
+		const T SegmentLength() const { return h_; }
+
+	private:
+		// segments are ordered along the curve, so median split by index keeps boxes tight
+		int Build(int begin, int end) {
+			const int id = static_cast<int>(nodes_.size());
+			nodes_.emplace_back();
+			if (end - begin == 1) {
+				nodes_[id].box = seg_boxes_[begin];
+				nodes_[id].seg = begin;
+				return id;
+			}
+			const int mid = (begin + end) / 2;
+			const int l = Build(begin, mid);
+			const int r = Build(mid, end);
+			Box b = nodes_[l].box;
+			for (int k = 0; k < 3; ++k) {
+				b.lo[k] = std::min(b.lo[k], nodes_[r].box.lo[k]);
+				b.hi[k] = std::max(b.hi[k], nodes_[r].box.hi[k]);
+			}
+			nodes_[id].box = b;
+			nodes_[id].left = l;
+			nodes_[id].right = r;
+			return id;
+		}
+	};
+
+	// Central difference - GetDerivativeByParam() is normalized, Newton needs the real one
+	template <typename T>
+	void RawDerivative(const Curve<T>& c, T t, T d[3]) {
+		const T h = static_cast<T>(1e-5) * (1 + std::fabs(t));
+		const Point<T> a = c.GetPointByParam(t + h);
+		const Point<T> b = c.GetPointByParam(t - h);
+		d[0] = (a.GetX() - b.GetX()) / (2 * h);
+		d[1] = (a.GetY() - b.GetY()) / (2 * h);
+		d[2] = (a.GetZ() - b.GetZ()) / (2 * h);
+	}
+
+	// Gauss-Newton (slightly damped) on |C1(s) - C2(t)|^2. Returns false if no contact near the start
+	template <typename T>
+	bool RefinePair(const Curve<T>& c1, const Curve<T>& c2, T& s, T& t) {
+		for (int it = 0; it < 50; ++it) {
+			const Point<T> p = c1.GetPointByParam(s);
+			const Point<T> q = c2.GetPointByParam(t);
+			const T f[3] = { p.GetX() - q.GetX(), p.GetY() - q.GetY(), p.GetZ() - q.GetZ() };
+			const T dist = std::sqrt(f[0] * f[0] + f[1] * f[1] + f[2] * f[2]);
+			T a[3], b[3];			// J = [a, -b]
+			RawDerivative(c1, s, a);
+			RawDerivative(c2, t, b);
+			const T aa = a[0] * a[0] + a[1] * a[1] + a[2] * a[2];
+			const T bb = b[0] * b[0] + b[1] * b[1] + b[2] * b[2];
+			const T ab = a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+			const T af = a[0] * f[0] + a[1] * f[1] + a[2] * f[2];
+			const T bf = b[0] * f[0] + b[1] * f[1] + b[2] * f[2];
+			const T lambda = static_cast<T>(1e-9) * (aa + bb);			// keeps tangent contacts solvable
+			// [aa+l  -ab ] [ds]   [-af]
+			// [-ab   bb+l] [dt] = [ bf]
+			const T det = (aa + lambda) * (bb + lambda) - ab * ab;
+			// crossing at an angle: close enough is done. At a tangent contact a whole parameter window
+			// is within tolerance - keep going, the iterations converge (linearly) to the touching point itself
+			if (dist < Tolerance<T>() && det > static_cast<T>(1e-4) * aa * bb)
+				return true;
+			if (dist == 0)
+				break;
+			if (det == 0)
+				return false;
+			const T ds = (-af * (bb + lambda) + ab * bf) / det;
+			const T dt = ((aa + lambda) * bf - ab * af) / det;
+			s += ds;
+			t += dt;
+			if (std::fabs(ds) + std::fabs(dt) < std::numeric_limits<T>::epsilon() * (1 + std::fabs(s) + std::fabs(t)))
+				break;
+		}
+		return AlmostEqual(c1.GetPointByParam(s), c2.GetPointByParam(t));
+	}
+
+}		// namespace IntersectionDetail
+
+/*********************************** Curve-plane intersections ***************************************/
+
+// All functions return sorted parameters in [t0, t1] where the curve hits the plane.
+// Curve lying entirely in the plane is reported as no intersection.
+
+template <typename T>
+std::vector<T> IntersectPlane(const Circle<T>& c, const Plane<T>& pl, T t0, T t1) {
+	return IntersectionDetail::SolveHarmonic(pl.GetNX() * c.GetRad(), pl.GetNY() * c.GetRad(), pl.GetOffset(), t0, t1);
+}
+
+template <typename T>
+std::vector<T> IntersectPlane(const Ellipsis<T>& e, const Plane<T>& pl, T t0, T t1) {
+	return IntersectionDetail::SolveHarmonic(pl.GetNX() * e.GetRadX(), pl.GetNY() * e.GetRadY(), pl.GetOffset(), t0, t1);
+}
+
+// f(t) = A*cos(t) + B*sin(t) + K*t - D. Splitting [t0, t1] by the critical points of f
+// leaves monotonic pieces with at most one root each; critical points touching zero are tangent contacts
+template <typename T>
+std::vector<T> IntersectPlane(const Helix<T>& h, const Plane<T>& pl, T t0, T t1) {
+	using namespace IntersectionDetail;
+	const T A = pl.GetNX() * h.GetRad();
+	const T B = pl.GetNY() * h.GetRad();
+	const T K = pl.GetNZ() * h.GetStep() / static_cast<T>(2 * PI);
+	const T D = pl.GetOffset();
+
+	if (K == 0)						// horizontal helix axis component - plain harmonic
+		return SolveHarmonic(A, B, D, t0, t1);
+
+	auto f = [=](T t) { return A * std::cos(t) + B * std::sin(t) + K * t - D; };
+	auto df = [=](T t) { return -A * std::sin(t) + B * std::cos(t) + K; };
+
+	// df == 0  <=>  R*cos(t - psi) == -K
+	std::vector<T> cuts{ t0 };
+	const T R = std::hypot(A, B);
+	if (R > std::fabs(K)) {
+		const T psi = std::atan2(-A, B);
+		const T delta = std::acos(-K / R);
+		AddPeriodic(psi + delta, t0, t1, cuts);
+		AddPeriodic(psi - delta, t0, t1, cuts);
+	}
+	cuts.push_back(t1);
+	std::sort(cuts.begin(), cuts.end());
+
+	std::vector<T> ret;
+	for (size_t i = 0; i + 1 < cuts.size(); ++i) {
+		const T a = cuts[i];
+		const T b = cuts[i + 1];
+		const T fa = f(a);
+		const T fb = f(b);
+		if (std::fabs(fa) < Tolerance<T>())
+			ret.push_back(a);
+		else if (std::fabs(fb) < Tolerance<T>())
+			ret.push_back(b);
+		else if ((fa < 0) != (fb < 0))
+			ret.push_back(NewtonBisect<T>(f, df, a, b));
+	}
+	SortUnique(ret);
+	return ret;
+}
+
+// Dispatch by curve kind. Unknown kinds fall back to bracketing sampled sign changes
+template <typename T>
+std::vector<T> IntersectPlane(const Curve<T>& c, const Plane<T>& pl, T t0, T t1) {
+	switch (c.GetKind()) {
+	case CurveKind::Circle:
+		return IntersectPlane(static_cast<const Circle<T>&>(c), pl, t0, t1);
+	case CurveKind::Ellipsis:
+		return IntersectPlane(static_cast<const Ellipsis<T>&>(c), pl, t0, t1);
+	case CurveKind::Helix:
+		return IntersectPlane(static_cast<const Helix<T>&>(c), pl, t0, t1);
+	default:
+		break;
+	}
+	using namespace IntersectionDetail;
+	std::vector<T> ret;
+	const int samples = 1024;
+	const T h = (t1 - t0) / samples;
+	auto f = [&](T t) { return pl.Eval(c.GetPointByParam(t)); };
+	auto df = [&](T t) { return (f(t + h / 64) - f(t - h / 64)) / (h / 32); };
+	T prev = f(t0);
+	for (int i = 1; i <= samples; ++i) {
+		const T a = t0 + h * (i - 1);
+		const T b = t0 + h * i;
+		const T cur = f(b);
+		if (std::fabs(prev) < Tolerance<T>())
+			ret.push_back(a);
+		else if ((prev < 0) != (cur < 0))
+			ret.push_back(NewtonBisect<T>(f, df, a, b));
+		prev = cur;
+	}
+	if (std::fabs(prev) < Tolerance<T>())
+		ret.push_back(t1);
+	SortUnique(ret);
+	return ret;
+}
+
+// Batch API: one result vector per curve, curves processed in parallel
+template <typename T>
+std::vector<std::vector<T>> IntersectPlane(const std::vector<Curve<T>*>& curves, const Plane<T>& pl, T t0, T t1) {
+	std::vector<std::vector<T>> ret(curves.size());
+	std::transform(
+		std::execution::par,
+		curves.begin(), curves.end(), ret.begin(),
+		[&pl, t0, t1](const Curve<T>* c) {
+			return IntersectPlane(*c, pl, t0, t1);
+		}
+	);
+	return ret;
+}
+
+/*********************************** Curve-curve intersections ***************************************/
+
+// Parameter pairs (s on c1, t on c2) where the curves meet, s in [s0, s1], t in [t0, t1].
+// Both ranges are cut into `segments` pieces, BVH traversal keeps only overlapping piece pairs,
+// each surviving pair is refined by Newton from the pieces' midpoints
+template <typename T>
+std::vector<std::pair<T, T>> IntersectCurves(const Curve<T>& c1, T s0, T s1, const Curve<T>& c2, T t0, T t1, int segments = 256) {
+	using namespace IntersectionDetail;
+	const SegmentBVH<T> bvh1(c1, s0, s1, segments);
+	const SegmentBVH<T> bvh2(c2, t0, t1, segments);
+	const auto& n1 = bvh1.GetNodes();
+	const auto& n2 = bvh2.GetNodes();
+
+	std::vector<std::pair<T, T>> ret;
+	std::vector<T> gaps;				// distance between the curves at every hit
+	std::vector<std::pair<int, int>> stack{ { 0, 0 } };
+	while (!stack.empty()) {
+		const auto [a, b] = stack.back();
+		stack.pop_back();
+		if (!Overlap(n1[a].box, n2[b].box))
+			continue;
+		const bool leafA = n1[a].seg >= 0;
+		const bool leafB = n2[b].seg >= 0;
+		if (leafA && leafB) {
+			const T hs = bvh1.SegmentLength();
+			const T ht = bvh2.SegmentLength();
+			T s = bvh1.SegmentBegin(n1[a].seg) + hs / 2;
+			T t = bvh2.SegmentBegin(n2[b].seg) + ht / 2;
+			if (!RefinePair(c1, c2, s, t))
+				continue;
+			if (s < s0 - Tolerance<T>() || s > s1 + Tolerance<T>() || t < t0 - Tolerance<T>() || t > t1 + Tolerance<T>())
+				continue;
+			// neighbouring leaf pairs converge to the same contact - near a tangent contact only up to
+			// ~sqrt(Tolerance) in the parameters, so hits within one leaf of each other are one contact, the closest one kept
+			const T gap = Distance(c1.GetPointByParam(s), c2.GetPointByParam(t));
+			const auto known = std::find_if(ret.begin(), ret.end(), [=](const std::pair<T, T>& h) {
+				return std::fabs(h.first - s) < hs && std::fabs(h.second - t) < ht;
+			});
+			if (known == ret.end()) {
+				ret.emplace_back(s, t);
+				gaps.push_back(gap);
+			}
+			else if (gap < gaps[known - ret.begin()]) {
+				*known = { s, t };
+				gaps[known - ret.begin()] = gap;
+			}
+		}
+		else if (!leafA && (leafB || a <= b)) {			// descend both sides in turn
+			stack.emplace_back(n1[a].left, b);
+			stack.emplace_back(n1[a].right, b);
+		}
+		else {
+			stack.emplace_back(a, n2[b].left);
+			stack.emplace_back(a, n2[b].right);
+		}
+	}
+	std::sort(ret.begin(), ret.end());
+	return ret;
+}
@@ -0,0 +1,242 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <execution>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+#include "curve.h"
+#include "circle.h"
+#include "ellipsis.h"
+#include "helix.h"
+
+// Closed-form per-curve metrics and deterministic parallel reductions over collections.
+// Circle and Ellipsis metrics are for the whole closed curve, Helix ones - for a parameter range.
+
+template <typename T>
+struct Bounds {
+	T lo[3] = { std::numeric_limits<T>::max(), std::numeric_limits<T>::max(), std::numeric_limits<T>::max() };
+	T hi[3] = { std::numeric_limits<T>::lowest(), std::numeric_limits<T>::lowest(), std::numeric_limits<T>::lowest() };
+
+	const bool IsEmpty() const {
+		return lo[0] > hi[0];
+	}
+
+	// min/max are exact, so merge order never changes the result
+	void Merge(const Bounds& other) {
+		for (int k = 0; k < 3; ++k) {
+			lo[k] = std::min(lo[k], other.lo[k]);
+			hi[k] = std::max(hi[k], other.hi[k]);
+		}
+	}
+};
+
+template <typename T>
+struct CollectionMetrics {
+	T total_length = 0;
+	T total_area = 0;				// Circle and Ellipsis only
+	T total_helix_height = 0;
+	Bounds<T> bounds;
+	size_t skipped = 0;				// kinds without closed-form metrics here (anything but Circle, Ellipsis, Helix)
+};
+
+/*********************************** Implementation details ***************************************/
+
+namespace MetricsDetail {
+
+	constexpr double PI = 3.14159265358979323846;
+
+	// Block sums have fixed boundaries and are added in fixed order:
+	// same input => bit-identical result regardless of thread count or scheduling
+	constexpr size_t BLOCK = 1024;
+
+	// Extent of rad * cos(t) over [t0, t1]: endpoints plus every multiple of PI inside
+	template <typename T>
+	void CosRange(T rad, T t0, T t1, T& lo, T& hi) {
+		if (t1 - t0 >= static_cast<T>(2 * PI)) {
+			lo = -rad;
+			hi = rad;
+			return;
+		}
+		lo = std::min(rad * std::cos(t0), rad * std::cos(t1));
+		hi = std::max(rad * std::cos(t0), rad * std::cos(t1));
+		for (T k = std::ceil(t0 / static_cast<T>(PI)); k * static_cast<T>(PI) <= t1; k += 1) {
+			const T v = std::fmod(k, static_cast<T>(2)) == 0 ? rad : -rad;
+			lo = std::min(lo, v);
+			hi = std::max(hi, v);
+		}
+	}
+
+	template <typename T>
+	struct PerCurve {
+		T length = 0;
+		T area = 0;
+		T height = 0;
+		Bounds<T> bounds;
+		bool known = true;
+	};
+
+}		// namespace MetricsDetail
+
+/*********************************** Per-curve metrics ***************************************/
+
+template <typename T>
+T Length(const Circle<T>& c) {
+	return static_cast<T>(2 * MetricsDetail::PI) * c.GetRad();
+}
+
+// Ramanujan's second approximation. Relative error: <1e-9 up to axis ratio 2:1, ~1e-5 at 10:1, <4e-4 worst case
+template <typename T>
+T Length(const Ellipsis<T>& e) {
+	const T a = e.GetRadX();
+	const T b = e.GetRadY();
+	const T h = (a - b) * (a - b) / ((a + b) * (a + b));
+	return static_cast<T>(MetricsDetail::PI) * (a + b) * (1 + 3 * h / (10 + std::sqrt(4 - 3 * h)));
+}
+
+// Helix is a line on the unrolled cylinder: |dC/dt| = sqrt(rad^2 + (step / 2PI)^2) is constant
+template <typename T>
+T Length(const Helix<T>& h, T t0, T t1) {
+	const T rise = h.GetStep() / static_cast<T>(2 * MetricsDetail::PI);
+	return std::fabs(t1 - t0) * std::sqrt(h.GetRad() * h.GetRad() + rise * rise);
+}
+
+template <typename T>
+T Area(const Circle<T>& c) {
+	return static_cast<T>(MetricsDetail::PI) * c.GetRad() * c.GetRad();
+}
+
+template <typename T>
+T Area(const Ellipsis<T>& e) {
+	return static_cast<T>(MetricsDetail::PI) * e.GetRadX() * e.GetRadY();
+}
+
+// z(t1) - z(t0), negative for a left-handed (step < 0) helix going up in parameter
+template <typename T>
+T Height(const Helix<T>& h, T t0, T t1) {
+	return (t1 - t0) * h.GetStep() / static_cast<T>(2 * MetricsDetail::PI);
+}
+
+template <typename T>
+Bounds<T> BoundingBox(const Circle<T>& c) {
+	Bounds<T> ret;
+	ret.lo[0] = ret.lo[1] = -c.GetRad();
+	ret.hi[0] = ret.hi[1] = c.GetRad();
+	ret.lo[2] = ret.hi[2] = 0;
+	return ret;
+}
+
+template <typename T>
+Bounds<T> BoundingBox(const Ellipsis<T>& e) {
+	Bounds<T> ret;
+	ret.lo[0] = -e.GetRadX();
+	ret.hi[0] = e.GetRadX();
+	ret.lo[1] = -e.GetRadY();
+	ret.hi[1] = e.GetRadY();
+	ret.lo[2] = ret.hi[2] = 0;
+	return ret;
+}
+
+// Exact box of the helix piece over [t0, t1] - partial turns included
+template <typename T>
+Bounds<T> BoundingBox(const Helix<T>& h, T t0, T t1) {
+	if (t1 < t0)
+		std::swap(t0, t1);
+	Bounds<T> ret;
+	const T half_pi = static_cast<T>(MetricsDetail::PI / 2);
+	MetricsDetail::CosRange(h.GetRad(), t0, t1, ret.lo[0], ret.hi[0]);
+	MetricsDetail::CosRange(h.GetRad(), t0 - half_pi, t1 - half_pi, ret.lo[1], ret.hi[1]);		// sin(t) = cos(t - PI/2)
+	const T z0 = h.GetPointByParam(t0).GetZ();
+	const T z1 = h.GetPointByParam(t1).GetZ();
+	ret.lo[2] = std::min(z0, z1);
+	ret.hi[2] = std::max(z0, z1);
+	return ret;
+}
+
+/*********************************** Reductions ***************************************/
+
+// Deterministic parallel sum: fixed 1024-element blocks summed in parallel, block sums added in order
+template <typename T>
+T DeterministicSum(const std::vector<T>& values) {
+	const size_t blocks = (values.size() + MetricsDetail::BLOCK - 1) / MetricsDetail::BLOCK;
+	std::vector<size_t> ids(blocks);
+	std::iota(ids.begin(), ids.end(), size_t(0));
+	std::vector<T> partial(blocks);
+	std::transform(
+		std::execution::par,
+		ids.begin(), ids.end(), partial.begin(),
+		[&values](size_t b) {
+			const size_t begin = b * MetricsDetail::BLOCK;
+			const size_t end = std::min(begin + MetricsDetail::BLOCK, values.size());
+			T sum = 0;
+			for (size_t i = begin; i < end; ++i)
+				sum += values[i];
+			return sum;
+		}
+	);
+	T ret = 0;
+	for (T s : partial)
+		ret += s;
+	return ret;
+}
+
+// One parallel pass computing closed-form metrics of every curve; helices are taken over [t0, t1]
+template <typename T>
+CollectionMetrics<T> ComputeMetrics(const std::vector<Curve<T>*>& curves, T t0, T t1) {
+	using MetricsDetail::PerCurve;
+	std::vector<PerCurve<T>> per(curves.size());
+	std::transform(
+		std::execution::par,
+		curves.begin(), curves.end(), per.begin(),
+		[t0, t1](const Curve<T>* cur) {
+			PerCurve<T> m;
+			switch (cur->GetKind()) {
+			case CurveKind::Circle: {
+				const Circle<T>& c = static_cast<const Circle<T>&>(*cur);
+				m.length = Length(c);
+				m.area = Area(c);
+				m.bounds = BoundingBox(c);
+				break;
+			}
+			case CurveKind::Ellipsis: {
+				const Ellipsis<T>& e = static_cast<const Ellipsis<T>&>(*cur);
+				m.length = Length(e);
+				m.area = Area(e);
+				m.bounds = BoundingBox(e);
+				break;
+			}
+			case CurveKind::Helix: {
+				const Helix<T>& h = static_cast<const Helix<T>&>(*cur);
+				m.length = Length(h, t0, t1);
+				m.height = Height(h, t0, t1);
+				m.bounds = BoundingBox(h, t0, t1);
+				break;
+			}
+			default:
+				m.known = false;
+				break;
+			}
+			return m;
+		}
+	);
+
+	CollectionMetrics<T> ret;
+	std::vector<T> column(per.size());
+	auto reduce_column = [&](T PerCurve<T>::* field) {
+		std::transform(per.begin(), per.end(), column.begin(), [field](const PerCurve<T>& m) { return m.*field; });
+		return DeterministicSum(column);
+	};
+	ret.total_length = reduce_column(&PerCurve<T>::length);
+	ret.total_area = reduce_column(&PerCurve<T>::area);
+	ret.total_helix_height = reduce_column(&PerCurve<T>::height);
+	for (const PerCurve<T>& m : per) {
+		if (m.known)
+			ret.bounds.Merge(m.bounds);
+		else
+			++ret.skipped;
+	}
+	return ret;
+}
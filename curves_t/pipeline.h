@@ -0,0 +1,385 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "curve_store.h"
+
+// Staged processing: source -> stage -> ... -> sink, every stage on its own thread,
+// neighbours connected by bounded single-producer/single-consumer rings.
+// A full ring stalls the producer (backpressure), so all stages overlap, the whole thing
+// runs at the speed of the slowest stage and memory is capped by ring capacities.
+// Items the sink is done with travel back to the source through one more ring and get reused -
+// no allocations in steady state.
+
+/*********************************** SPSC ring ***************************************/
+
+template <typename Item>
+class SpscRing {
+private:			// fields
+	static constexpr size_t CACHE_LINE = 64;
+
+	std::vector<Item> slots_;
+	const size_t mask_;
+	alignas(CACHE_LINE) std::atomic<size_t> head_{ 0 };			// next slot to read, written by consumer
+	alignas(CACHE_LINE) std::atomic<size_t> tail_{ 0 };			// next slot to write, written by producer
+
+public:				// constructors
+	SpscRing() = delete;
+	explicit SpscRing(size_t capacity);			// rounded up to a power of two
+	SpscRing(const SpscRing&) = delete;
+	SpscRing& operator=(const SpscRing&) = delete;
+
+public:				// methods
+	bool TryPush(Item& item);			// moves from item on success
+	bool TryPop(Item& item);
+	const size_t Capacity() const;
+};
+
+template <typename Item>
+SpscRing<Item>::SpscRing(size_t capacity) : slots_([capacity] {
+		size_t n = 1;
+		while (n < capacity)
+			n <<= 1;
+		return n;
+	}()), mask_(slots_.size() - 1) {
+}
+
+template <typename Item>
+bool SpscRing<Item>::TryPush(Item& item) {
+	const size_t tail = tail_.load(std::memory_order_relaxed);
+	if (tail - head_.load(std::memory_order_acquire) == slots_.size())
+		return false;
+	slots_[tail & mask_] = std::move(item);
+	tail_.store(tail + 1, std::memory_order_release);
+	return true;
+}
+
+template <typename Item>
+bool SpscRing<Item>::TryPop(Item& item) {
+	const size_t head = head_.load(std::memory_order_relaxed);
+	if (head == tail_.load(std::memory_order_acquire))
+		return false;
+	item = std::move(slots_[head & mask_]);
+	head_.store(head + 1, std::memory_order_release);
+	return true;
+}
+
+template <typename Item>
+const size_t SpscRing<Item>::Capacity() const {
+	return slots_.size();
+}
+
+/*********************************** Pipeline ***************************************/
+
+struct StageStats {
+	uint64_t items = 0;
+	uint64_t busy_ns = 0;				// time inside the stage function
+	uint64_t stalls_full = 0;			// times blocked on a full output ring - this stage is faster than the next
+	uint64_t stalls_empty = 0;			// times blocked on an empty input ring - this stage is faster than the previous
+};
+
+// Pins the calling thread to one CPU. No-op where unsupported
+inline void PinCurrentThread(int cpu) {
+	if (cpu < 0)
+		return;
+#if defined(_WIN32)
+	SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << cpu);
+#elif defined(__linux__)
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	CPU_SET(cpu, &set);
+	pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#endif
+}
+
+template <typename Item>
+class Pipeline {
+public:				// types
+	using Source = std::function<bool(Item&)>;			// fills the item, false - end of stream
+	using Stage = std::function<void(Item&)>;
+
+private:			// fields
+	struct StageDesc {
+		Stage func;
+		int cpu;
+	};
+
+	const size_t capacity_;
+	Source source_;
+	int source_cpu_ = -1;
+	std::vector<StageDesc> stages_;			// middle stages + sink (last)
+	std::atomic<bool> abort_{ false };
+
+public:				// constructors
+	Pipeline() = delete;
+	explicit Pipeline(size_t queue_capacity = 64);
+
+public:				// methods
+	// cpu < 0 - no pinning
+	Pipeline& SetSource(Source source, int cpu = -1);
+	Pipeline& AddStage(Stage stage, int cpu = -1);
+	Pipeline& SetSink(Stage sink, int cpu = -1);
+
+	// Blocks until the source is exhausted and everything is drained.
+	// Returns stats of the source and every stage; rethrows the first exception of any stage
+	std::vector<StageStats> Run();
+
+private:
+	// spin a bit, then give the core away
+	static void Backoff(unsigned& spins);
+};
+
+/****************************************** DEFINITIONS ************************************************/
+
+template <typename Item>
+Pipeline<Item>::Pipeline(size_t queue_capacity) : capacity_(queue_capacity) {
+	if (queue_capacity == 0)
+		throw std::logic_error("Queue capacity must be positive");
+}
+
+template <typename Item>
+Pipeline<Item>& Pipeline<Item>::SetSource(Source source, int cpu) {
+	source_ = std::move(source);
+	source_cpu_ = cpu;
+	return *this;
+}
+
+template <typename Item>
+Pipeline<Item>& Pipeline<Item>::AddStage(Stage stage, int cpu) {
+	stages_.push_back({ std::move(stage), cpu });
+	return *this;
+}
+
+template <typename Item>
+Pipeline<Item>& Pipeline<Item>::SetSink(Stage sink, int cpu) {
+	return AddStage(std::move(sink), cpu);
+}
+
+template <typename Item>
+void Pipeline<Item>::Backoff(unsigned& spins) {
+	if (++spins < 64)
+		return;
+	std::this_thread::yield();
+}
+
+template <typename Item>
+std::vector<StageStats> Pipeline<Item>::Run() {
+	using Clock = std::chrono::steady_clock;
+	if (!source_ || stages_.empty())
+		throw std::logic_error("Pipeline needs a source and a sink");
+
+	const size_t links = stages_.size();
+	std::vector<std::unique_ptr<SpscRing<Item>>> rings;
+	for (size_t i = 0; i < links; ++i)
+		rings.push_back(std::make_unique<SpscRing<Item>>(capacity_));
+	// sized for every item that can be alive at once; if it still is full, the item is just dropped
+	SpscRing<Item> recycle(capacity_ * (links + 1));
+	std::vector<std::atomic<bool>> finished(links);			// producer of link i is done
+	for (auto& f : finished)
+		f.store(false);
+	std::vector<StageStats> stats(links + 1);
+	std::vector<std::exception_ptr> errors(links + 1);
+	abort_.store(false);
+
+	auto push = [this](SpscRing<Item>& ring, Item& item, StageStats& st) {
+		unsigned spins = 0;
+		while (!ring.TryPush(item)) {
+			if (abort_.load(std::memory_order_relaxed))
+				return false;
+			if (spins == 0)					// one stall per wait, not per retry
+				++st.stalls_full;
+			Backoff(spins);
+		}
+		return true;
+	};
+
+	std::vector<std::thread> threads;
+	threads.emplace_back([&] {
+		PinCurrentThread(source_cpu_);
+		StageStats& st = stats[0];
+		try {
+			for (;;) {
+				Item item;
+				recycle.TryPop(item);			// reuse a drained item if there is one
+				const auto start = Clock::now();
+				const bool more = source_(item);
+				st.busy_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+				if (!more || !push(*rings[0], item, st))
+					break;
+				++st.items;
+			}
+		}
+		catch (...) {
+			errors[0] = std::current_exception();
+			abort_.store(true);
+		}
+		finished[0].store(true, std::memory_order_release);
+	});
+
+	for (size_t s = 0; s < links; ++s) {
+		threads.emplace_back([&, s] {
+			PinCurrentThread(stages_[s].cpu);
+			StageStats& st = stats[s + 1];
+			const bool is_sink = s + 1 == links;
+			try {
+				Item item;
+				unsigned spins = 0;
+				for (;;) {
+					if (abort_.load(std::memory_order_relaxed))
+						break;
+					if (!rings[s]->TryPop(item)) {
+						// producer flag first, then one more look - nothing can slip in between
+						const bool done = finished[s].load(std::memory_order_acquire);
+						if (!done) {
+							if (spins == 0)
+								++st.stalls_empty;
+							Backoff(spins);
+							continue;
+						}
+						if (!rings[s]->TryPop(item))
+							break;
+					}
+					spins = 0;
+					const auto start = Clock::now();
+					stages_[s].func(item);
+					st.busy_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+					++st.items;
+					if (is_sink)
+						recycle.TryPush(item);
+					else if (!push(*rings[s + 1], item, st))
+						break;
+				}
+			}
+			catch (...) {
+				errors[s + 1] = std::current_exception();
+				abort_.store(true);
+			}
+			if (!is_sink)
+				finished[s + 1].store(true, std::memory_order_release);
+		});
+	}
+
+	for (std::thread& t : threads)
+		t.join();
+	for (const std::exception_ptr& e : errors)
+		if (e)
+			std::rethrow_exception(e);
+	return stats;
+}
+
+/*********************************** Curve processing stages ***************************************/
+
+// Unit of work flowing through a curve pipeline: `count` samples of one stored curve
+template <typename T>
+struct CurveBatch {
+	size_t curve = 0;
+	size_t first_sample = 0;
+	size_t count = 0;
+	std::vector<T> params;
+	std::vector<T> xs, ys, zs;				// points
+	std::vector<T> tx, ty, tz;				// unit tangents (frames)
+};
+
+namespace PipelineStages {
+
+	// Enumerates (curve, sample range) work items: `samples` points over [t0, t1] per curve, `batch` per item
+	template <typename T>
+	typename Pipeline<CurveBatch<T>>::Source Work(const CurveStore<T>& store, T t0, T t1, size_t samples, size_t batch) {
+		if (batch == 0)
+			throw std::logic_error("Batch size must be positive");
+		const T step = samples > 1 ? (t1 - t0) / static_cast<T>(samples - 1) : 0;
+		auto curve = std::make_shared<size_t>(0);
+		auto next = std::make_shared<size_t>(0);
+		return [&store, t0, step, samples, batch, curve, next](CurveBatch<T>& item) {
+			if (*next >= samples) {
+				*next = 0;
+				++*curve;
+			}
+			if (*curve >= store.Size() || samples == 0)
+				return false;
+			item.curve = *curve;
+			item.first_sample = *next;
+			item.count = std::min(batch, samples - *next);
+			item.params.resize(item.count);			// no-op for recycled items
+			for (size_t i = 0; i < item.count; ++i)
+				item.params[i] = t0 + step * static_cast<T>(item.first_sample + i);
+			*next += item.count;
+			return true;
+		};
+	}
+
+	template <typename T>
+	typename Pipeline<CurveBatch<T>>::Stage Sample(const CurveStore<T>& store) {
+		return [&store](CurveBatch<T>& item) {
+			item.xs.resize(item.count);
+			item.ys.resize(item.count);
+			item.zs.resize(item.count);
+			store.GetPointsByParams(item.curve, item.params.data(), item.count, item.xs.data(), item.ys.data(), item.zs.data());
+		};
+	}
+
+	template <typename T>
+	typename Pipeline<CurveBatch<T>>::Stage Frames(const CurveStore<T>& store) {
+		return [&store](CurveBatch<T>& item) {
+			item.tx.resize(item.count);
+			item.ty.resize(item.count);
+			item.tz.resize(item.count);
+			for (size_t i = 0; i < item.count; ++i) {
+				const TriDvector<T> d = store.GetDerivativeByParam(item.curve, item.params[i]);
+				item.tx[i] = d.GetX();
+				item.ty[i] = d.GetY();
+				item.tz[i] = d.GetZ();
+			}
+		};
+	}
+
+	// Affine transform, row-major 3x4 [R | t]: points get R*p + t, tangents (if computed) R*v renormalized
+	template <typename T>
+	typename Pipeline<CurveBatch<T>>::Stage Transform(const std::array<T, 12>& m) {
+		return [m](CurveBatch<T>& item) {
+			for (size_t i = 0; i < item.count; ++i) {
+				const T x = item.xs[i], y = item.ys[i], z = item.zs[i];
+				item.xs[i] = m[0] * x + m[1] * y + m[2] * z + m[3];
+				item.ys[i] = m[4] * x + m[5] * y + m[6] * z + m[7];
+				item.zs[i] = m[8] * x + m[9] * y + m[10] * z + m[11];
+			}
+			if (item.tx.size() < item.count)
+				return;
+			for (size_t i = 0; i < item.count; ++i) {
+				const T x = item.tx[i], y = item.ty[i], z = item.tz[i];
+				T nx = m[0] * x + m[1] * y + m[2] * z;
+				T ny = m[4] * x + m[5] * y + m[6] * z;
+				T nz = m[8] * x + m[9] * y + m[10] * z;
+				const T len = std::sqrt(nx * nx + ny * ny + nz * nz);
+				item.tx[i] = nx / len;
+				item.ty[i] = ny / len;
+				item.tz[i] = nz / len;
+			}
+		};
+	}
+
+}		// namespace PipelineStages
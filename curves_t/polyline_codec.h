@@ -0,0 +1,196 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include "curve.h"
+#include "curve_store.h"
+
+// Error-bounded storage for sampled curves.
+// EncodePolyline snaps every coordinate to a grid of step q = 2 * bound / sqrt(3) (so the 3D error per point
+// is at most bound; q is shrunk a bit to cover floating point rounding), keeps second differences of the grid indices (smooth curves give near-zero values),
+// zigzags them to unsigned and bit-packs blocks of BLOCK values at the narrowest width that fits the block.
+// Quantization, differencing, zigzag and scaling are plain branch-free loops over arrays - they vectorize;
+// only the bit (un)packing and the prefix sums in decode are sequential.
+//
+// When the consumer knows the source curve, CurveDescriptor is smaller still: kind + parameters + t-range + count,
+// rebuilt exactly through the CurveStore evaluation path.
+
+template <typename T>
+struct EncodedPolyline {
+	T quantum = 0;							// grid step
+	size_t count = 0;						// points
+	std::vector<uint8_t> widths;			// bit width of every block: x blocks, then y, then z
+	std::vector<uint64_t> words;			// packed values, same order
+
+	const size_t GetByteSize() const {
+		return sizeof(quantum) + sizeof(count) + widths.size() + words.size() * sizeof(uint64_t);
+	}
+};
+
+template <typename T>
+struct CurveDescriptor {
+	CurveKind kind = CurveKind::Unknown;
+	T params[CurveStore<T>::PARAMS] = {};	// one CurveStore row
+	T t0 = 0;
+	T t1 = 0;
+	size_t count = 0;
+};
+
+/*********************************** Implementation details ***************************************/
+
+namespace CodecDetail {
+
+	constexpr size_t BLOCK = 128;
+
+	// Grid indices stay under 2^40: rounding of coord / q and index * q is then below 2^-13 grid steps,
+	// and SLACK shrinks q enough to keep the total within half a (nominal) step
+	constexpr double MAX_INDEX = 1099511627776.0;		// 2^40
+	constexpr double SLACK = 1 - 1.0 / 1024;
+
+	inline uint64_t ZigZag(int64_t v) {
+		return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+	}
+
+	inline int64_t UnZigZag(uint64_t v) {
+		return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
+	}
+
+	// Appends n values of width w starting at bit pos
+	inline void Pack(const uint64_t* values, size_t n, unsigned w, std::vector<uint64_t>& words, size_t& pos) {
+		if (w == 0)
+			return;
+		words.resize((pos + n * w + 63) / 64, 0);
+		for (size_t i = 0; i < n; ++i, pos += w) {
+			const size_t idx = pos >> 6;
+			const unsigned off = pos & 63;
+			words[idx] |= values[i] << off;
+			if (off + w > 64)
+				words[idx + 1] |= values[i] >> (64 - off);
+		}
+	}
+
+	inline void Unpack(const std::vector<uint64_t>& words, size_t n, unsigned w, uint64_t* values, size_t& pos) {
+		if (w == 0) {
+			std::fill(values, values + n, uint64_t(0));
+			return;
+		}
+		const uint64_t mask = w == 64 ? ~uint64_t(0) : (uint64_t(1) << w) - 1;
+		for (size_t i = 0; i < n; ++i, pos += w) {
+			const size_t idx = pos >> 6;
+			const unsigned off = pos & 63;
+			uint64_t v = words[idx] >> off;
+			if (off + w > 64)
+				v |= words[idx + 1] << (64 - off);
+			values[i] = v & mask;
+		}
+	}
+
+	template <typename T>
+	void EncodeAxis(const T* coords, size_t count, T quantum, std::vector<int64_t>& grid, std::vector<uint64_t>& residuals,
+		EncodedPolyline<T>& out, size_t& pos) {
+		const double inv = 1.0 / quantum;
+		bool in_range = true;
+		for (size_t i = 0; i < count; ++i) {
+			const double g = std::nearbyint(coords[i] * inv);
+			in_range &= std::fabs(g) < MAX_INDEX;			// false for NaN and inf too
+			grid[i] = in_range ? static_cast<int64_t>(g) : 0;
+		}
+		if (!in_range)
+			throw std::logic_error("Polyline coordinates out of quantization range");
+
+		if (count > 0)
+			residuals[0] = ZigZag(grid[0]);
+		if (count > 1)
+			residuals[1] = ZigZag(grid[1] - grid[0]);
+		for (size_t i = 2; i < count; ++i)
+			residuals[i] = ZigZag(grid[i] - 2 * grid[i - 1] + grid[i - 2]);
+
+		for (size_t b = 0; b < count; b += BLOCK) {
+			const size_t n = std::min(BLOCK, count - b);
+			uint64_t all = 0;
+			for (size_t i = 0; i < n; ++i)
+				all |= residuals[b + i];
+			const unsigned w = static_cast<unsigned>(std::bit_width(all));
+			out.widths.push_back(static_cast<uint8_t>(w));
+			Pack(residuals.data() + b, n, w, out.words, pos);
+		}
+	}
+
+	template <typename T>
+	void DecodeAxis(const EncodedPolyline<T>& enc, size_t& block, size_t& pos, std::vector<uint64_t>& residuals, T* coords) {
+		const size_t count = enc.count;
+		for (size_t b = 0; b < count; b += BLOCK, ++block)
+			Unpack(enc.words, std::min(BLOCK, count - b), enc.widths[block], residuals.data() + b, pos);
+
+		for (size_t i = 0; i < count; ++i)
+			residuals[i] = static_cast<uint64_t>(UnZigZag(residuals[i]));
+		// undo both differences with sequential prefix sums; unsigned wraparound keeps them well defined
+		for (size_t i = 2; i < count; ++i)
+			residuals[i] += residuals[i - 1];
+		for (size_t i = 1; i < count; ++i)
+			residuals[i] += residuals[i - 1];
+		for (size_t i = 0; i < count; ++i)
+			coords[i] = static_cast<T>(static_cast<double>(static_cast<int64_t>(residuals[i])) * enc.quantum);
+	}
+
+}		// namespace CodecDetail
+
+/*********************************** Codec ***************************************/
+
+// Every decoded point lies within bound (Euclidean distance) of its source point
+template <typename T>
+EncodedPolyline<T> EncodePolyline(const T* xs, const T* ys, const T* zs, size_t count, T bound) {
+	if (!(bound > 0))
+		throw std::logic_error("Error bound must be positive");
+	EncodedPolyline<T> ret;
+	ret.quantum = static_cast<T>(2 * bound / std::sqrt(3.0) * CodecDetail::SLACK);
+	ret.count = count;
+	std::vector<int64_t> grid(count);
+	std::vector<uint64_t> residuals(count);
+	size_t pos = 0;
+	CodecDetail::EncodeAxis(xs, count, ret.quantum, grid, residuals, ret, pos);
+	CodecDetail::EncodeAxis(ys, count, ret.quantum, grid, residuals, ret, pos);
+	CodecDetail::EncodeAxis(zs, count, ret.quantum, grid, residuals, ret, pos);
+	return ret;
+}
+
+// Output arrays must hold enc.count values each
+template <typename T>
+void DecodePolyline(const EncodedPolyline<T>& enc, T* xs, T* ys, T* zs) {
+	std::vector<uint64_t> residuals(enc.count);
+	size_t block = 0;
+	size_t pos = 0;
+	CodecDetail::DecodeAxis(enc, block, pos, residuals, xs);
+	CodecDetail::DecodeAxis(enc, block, pos, residuals, ys);
+	CodecDetail::DecodeAxis(enc, block, pos, residuals, zs);
+}
+
+/*********************************** Descriptors ***************************************/
+
+// Samples t0 + (t1 - t0) * i / (count - 1), i = 0..count-1 - same grid as ShardedEvaluator
+template <typename T>
+CurveDescriptor<T> Describe(const CurveStore<T>& store, size_t index, T t0, T t1, size_t count) {
+	CurveDescriptor<T> ret;
+	ret.kind = store.GetKind(index);
+	store.GetRow(index, ret.params);
+	ret.t0 = t0;
+	ret.t1 = t1;
+	ret.count = count;
+	return ret;
+}
+
+// Output arrays must hold desc.count values each. Throws for unknown kinds, as CurveStore does
+template <typename T>
+void Rebuild(const CurveDescriptor<T>& desc, T* xs, T* ys, T* zs) {
+	std::vector<T> params(desc.count);
+	const T step = desc.count > 1 ? (desc.t1 - desc.t0) / static_cast<T>(desc.count - 1) : T(0);
+	for (size_t i = 0; i < desc.count; ++i)
+		params[i] = desc.t0 + step * static_cast<T>(i);
+	CurveStore<T>::Evaluate(desc.kind, desc.params, params.data(), desc.count, xs, ys, zs);
+}
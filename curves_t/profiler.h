@@ -0,0 +1,260 @@
+#pragma once
+
+// Compile-time switchable instrumentation.
+// Define CURVES_PROFILE to get evaluation counters and scoped stage timers,
+// define CURVES_PROFILE_FINE additionally to time trig vs Point construction inside every evaluation.
+// Without the defines every CURVES_PROFILE_* macro expands to nothing - zero cost in release runs.
+
+#if defined(CURVES_PROFILE_FINE) && !defined(CURVES_PROFILE)
+#define CURVES_PROFILE
+#endif
+
+#ifdef CURVES_PROFILE
+
+#include <atomic>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <list>
+#include <mutex>
+#include <string>
+
+namespace CurvesProfile {
+
+	enum class Counter {
+		CircleEval,
+		CircleDeriv,
+		EllipsisEval,
+		EllipsisDeriv,
+		HelixEval,
+		HelixDeriv,
+		SegmentEval,
+		SegmentDeriv,
+		ArcEval,
+		ArcDeriv,
+		EllipticHelixEval,
+		EllipticHelixDeriv,
+		ConicalSpiralEval,
+		ConicalSpiralDeriv,
+		BezierEval,
+		BezierDeriv,
+		BSplineEval,
+		BSplineDeriv,
+		CircleBatchPoint,
+		EllipsisBatchPoint,
+		HelixBatchPoint,
+		SegmentBatchPoint,
+		ArcBatchPoint,
+		EllipticHelixBatchPoint,
+		ConicalSpiralBatchPoint,
+		BezierBatchPoint,
+		BSplineBatchPoint,
+		Normalize,
+		COUNT				// keep last
+	};
+
+	inline const char* CounterName(Counter c) {
+		static const char* names[] = {
+			"Circle::GetPointByParam",
+			"Circle::GetDerivativeByParam",
+			"Ellipsis::GetPointByParam",
+			"Ellipsis::GetDerivativeByParam",
+			"Helix::GetPointByParam",
+			"Helix::GetDerivativeByParam",
+			"Segment::GetPointByParam",
+			"Segment::GetDerivativeByParam",
+			"Arc::GetPointByParam",
+			"Arc::GetDerivativeByParam",
+			"EllipticHelix::GetPointByParam",
+			"EllipticHelix::GetDerivativeByParam",
+			"ConicalSpiral::GetPointByParam",
+			"ConicalSpiral::GetDerivativeByParam",
+			"BezierSegment::GetPointByParam",
+			"BezierSegment::GetDerivativeByParam",
+			"BSplineSegment::GetPointByParam",
+			"BSplineSegment::GetDerivativeByParam",
+			"Circle::GetPointsByParams (points)",
+			"Ellipsis::GetPointsByParams (points)",
+			"Helix::GetPointsByParams (points)",
+			"Segment::GetPointsByParams (points)",
+			"Arc::GetPointsByParams (points)",
+			"EllipticHelix::GetPointsByParams (points)",
+			"ConicalSpiral::GetPointsByParams (points)",
+			"BezierSegment::GetPointsByParams (points)",
+			"BSplineSegment::GetPointsByParams (points)",
+			"TriDvector::Normalize"
+		};
+		return names[static_cast<int>(c)];
+	}
+
+	// log2-bucketed histogram of durations in nanoseconds. Bucket i holds [2^(i-1), 2^i) ns
+	class Histogram {
+	public:			// fields
+		static constexpr int BUCKETS = 48;
+
+	private:
+		const std::string name_;
+		std::array<std::atomic<uint64_t>, BUCKETS> buckets_{};
+		std::atomic<uint64_t> count_{ 0 };
+		std::atomic<uint64_t> total_ns_{ 0 };
+
+	public:			// constructors
+		Histogram() = delete;
+		explicit Histogram(std::string name) : name_(std::move(name)) {}
+
+	public:			// methods
+		void Add(uint64_t ns) {
+			int bucket = 0;
+			while (bucket < BUCKETS - 1 && (ns >> bucket) != 0)
+				++bucket;
+			buckets_[bucket].fetch_add(1, std::memory_order_relaxed);
+			count_.fetch_add(1, std::memory_order_relaxed);
+			total_ns_.fetch_add(ns, std::memory_order_relaxed);
+		}
+
+		const std::string& GetName() const { return name_; }
+		const uint64_t GetCount() const { return count_.load(std::memory_order_relaxed); }
+		const uint64_t GetTotalNs() const { return total_ns_.load(std::memory_order_relaxed); }
+		const uint64_t GetBucket(int i) const { return buckets_[i].load(std::memory_order_relaxed); }
+
+		void Reset() {
+			for (auto& b : buckets_)
+				b.store(0, std::memory_order_relaxed);
+			count_.store(0, std::memory_order_relaxed);
+			total_ns_.store(0, std::memory_order_relaxed);
+		}
+	};
+
+	class Registry {
+	private:		// fields
+		std::array<std::atomic<uint64_t>, static_cast<size_t>(Counter::COUNT)> counters_{};
+		std::list<Histogram> histograms_;			// list - references must stay valid while growing
+		std::mutex mutex_;
+
+	public:			// constructors
+		Registry() = default;
+		Registry(const Registry&) = delete;
+		Registry& operator=(const Registry&) = delete;
+
+	public:			// methods
+		static Registry& Get() {
+			static Registry instance;
+			return instance;
+		}
+
+		void Increment(Counter c, uint64_t n = 1) {
+			counters_[static_cast<size_t>(c)].fetch_add(n, std::memory_order_relaxed);
+		}
+
+		const uint64_t GetCounter(Counter c) const {
+			return counters_[static_cast<size_t>(c)].load(std::memory_order_relaxed);
+		}
+
+		// called once per timer site (static local in macro), so the lock is out of the hot path
+		Histogram& GetHistogram(const std::string& name) {
+			std::lock_guard<std::mutex> lock(mutex_);
+			for (Histogram& h : histograms_)
+				if (h.GetName() == name)
+					return h;
+			return histograms_.emplace_back(name);
+		}
+
+		void Reset() {
+			std::lock_guard<std::mutex> lock(mutex_);
+			for (auto& c : counters_)
+				c.store(0, std::memory_order_relaxed);
+			for (Histogram& h : histograms_)
+				h.Reset();
+		}
+
+		bool ExportText(const std::string& path) {
+			std::lock_guard<std::mutex> lock(mutex_);
+			std::ofstream out(path);
+			if (!out)
+				return false;
+			out << "# counters\n";
+			for (int i = 0; i < static_cast<int>(Counter::COUNT); ++i)
+				out << CounterName(static_cast<Counter>(i)) << " " << counters_[i].load(std::memory_order_relaxed) << "\n";
+			out << "# timers (bucket upper bound in ns : hits)\n";
+			for (const Histogram& h : histograms_) {
+				out << h.GetName() << " count=" << h.GetCount() << " total_ns=" << h.GetTotalNs() << "\n";
+				for (int b = 0; b < Histogram::BUCKETS; ++b)
+					if (h.GetBucket(b) != 0)
+						out << "  <" << (uint64_t(1) << b) << " : " << h.GetBucket(b) << "\n";
+			}
+			return static_cast<bool>(out);
+		}
+
+		bool ExportJson(const std::string& path) {
+			std::lock_guard<std::mutex> lock(mutex_);
+			std::ofstream out(path);
+			if (!out)
+				return false;
+			out << "{\n  \"counters\": {";
+			for (int i = 0; i < static_cast<int>(Counter::COUNT); ++i) {
+				out << (i ? ",\n" : "\n") << "    \"" << CounterName(static_cast<Counter>(i)) << "\": "
+					<< counters_[i].load(std::memory_order_relaxed);
+			}
+			out << "\n  },\n  \"timers\": [";
+			bool first = true;
+			for (const Histogram& h : histograms_) {
+				out << (first ? "\n" : ",\n") << "    { \"name\": \"" << h.GetName() << "\", \"count\": " << h.GetCount()
+					<< ", \"total_ns\": " << h.GetTotalNs() << ", \"buckets\": [";
+				for (int b = 0; b < Histogram::BUCKETS; ++b)
+					out << (b ? ", " : "") << h.GetBucket(b);
+				out << "] }";
+				first = false;
+			}
+			out << "\n  ]\n}\n";
+			return static_cast<bool>(out);
+		}
+	};
+
+	class ScopedTimer {
+	private:		// fields
+		Histogram& hist_;
+		const std::chrono::steady_clock::time_point start_;
+
+	public:			// constructors
+		ScopedTimer() = delete;
+		explicit ScopedTimer(Histogram& hist) : hist_(hist), start_(std::chrono::steady_clock::now()) {}
+		~ScopedTimer() {
+			auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_).count();
+			hist_.Add(static_cast<uint64_t>(ns));
+		}
+	};
+
+}		// namespace CurvesProfile
+
+#define CURVES_PROFILE_CAT_IMPL(a, b) a##b
+#define CURVES_PROFILE_CAT(a, b) CURVES_PROFILE_CAT_IMPL(a, b)
+
+#define CURVES_PROFILE_COUNT(counter) \
+	CurvesProfile::Registry::Get().Increment(CurvesProfile::Counter::counter)
+
+#define CURVES_PROFILE_COUNT_N(counter, n) \
+	CurvesProfile::Registry::Get().Increment(CurvesProfile::Counter::counter, (n))
+
+#define CURVES_PROFILE_SCOPE(name) \
+	static CurvesProfile::Histogram& CURVES_PROFILE_CAT(curves_hist_, __LINE__) = CurvesProfile::Registry::Get().GetHistogram(name); \
+	CurvesProfile::ScopedTimer CURVES_PROFILE_CAT(curves_timer_, __LINE__)(CURVES_PROFILE_CAT(curves_hist_, __LINE__))
+
+#define CURVES_PROFILE_EXPORT_TEXT(path) CurvesProfile::Registry::Get().ExportText(path)
+#define CURVES_PROFILE_EXPORT_JSON(path) CurvesProfile::Registry::Get().ExportJson(path)
+
+#else		// CURVES_PROFILE
+
+#define CURVES_PROFILE_COUNT(counter) ((void)0)
+#define CURVES_PROFILE_COUNT_N(counter, n) ((void)0)
+#define CURVES_PROFILE_SCOPE(name) ((void)0)
+#define CURVES_PROFILE_EXPORT_TEXT(path) ((void)0)
+#define CURVES_PROFILE_EXPORT_JSON(path) ((void)0)
+
+#endif		// CURVES_PROFILE
+
+#ifdef CURVES_PROFILE_FINE
+#define CURVES_PROFILE_FINE_SCOPE(name) CURVES_PROFILE_SCOPE(name)
+#else
+#define CURVES_PROFILE_FINE_SCOPE(name) ((void)0)
+#endif
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cmath>
+
+// Splits a parameter into whole turns and an angle in [-PI, PI]: param == turns * 2*PI + angle.
+// Cody-Waite reduction with 2*PI cut into three parts: TWO_PI_1 and TWO_PI_2 are fdlibm's pio2_1 and pio2_2 times 4,
+// TWO_PI_3 is the rest, 2*PI - TWO_PI_1 - TWO_PI_2 rounded to double (4 * (pio2_3 + pio2_3t) in fdlibm terms).
+// TWO_PI_1 and TWO_PI_2 have at most 33 significant bits, so the products are exact up to 2^20 turns
+// and the reduced angle keeps full double precision there. Past that it degrades slowly instead of
+// relying on libm's slow huge-argument path.
+namespace RangeReduction {
+
+	constexpr double TWO_PI = 6.28318530717958647692;
+	constexpr double INV_TWO_PI = 0.159154943091895335769;
+	constexpr double TWO_PI_1 = 6.28318530693650245667e+00;
+	constexpr double TWO_PI_2 = 2.43084020252158639064e-10;
+	constexpr double TWO_PI_3 = 8.08906499518380252616e-21;
+
+	// Returns turns, writes reduced angle. Done in double for float too - float can't hold the correction terms
+	inline double ReduceTurns(double param, double& angle) {
+		const double turns = std::nearbyint(param * INV_TWO_PI);
+		angle = ((param - turns * TWO_PI_1) - turns * TWO_PI_2) - turns * TWO_PI_3;
+		return turns;
+	}
+
+}		// namespace RangeReduction
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "curve.h"
+
+// Straight line through two points: param 0 gives start, param 1 - end, other params extrapolate
+template <typename T>
+class Segment final : public Curve<T> {
+private:		// fields
+	const T x0_, y0_, z0_;
+	const T dx_, dy_, dz_;			// end - start
+
+public:			// constructors
+	Segment() = delete;
+	explicit Segment(const Point<T>& start, const Point<T>& end);
+
+public:			// methods
+	const Point<T> GetStart() const;
+	const Point<T> GetEnd() const;
+	const Point<T> GetPointByParam(T param) const;
+	void GetPointsByParams(const T* params, std::size_t count, T* xs, T* ys, T* zs) const;
+	const TriDvector<T> GetDerivativeByParam(T param) const;
+
+	const bool IsCircle() const;
+	const CurveKind GetKind() const;
+};
+
+/****************************************** DEFINITIONS ************************************************/
+
+template <typename T>
+Segment<T>::Segment(const Point<T>& start, const Point<T>& end)
+	: x0_(start.GetX()), y0_(start.GetY()), z0_(start.GetZ()),
+	dx_(end.GetX() - start.GetX()), dy_(end.GetY() - start.GetY()), dz_(end.GetZ() - start.GetZ()) {
+	if (!std::is_floating_point<T>::value)
+		throw std::logic_error("Segment coordinate is NOT floating type");
+	if (dx_ == 0 && dy_ == 0 && dz_ == 0)
+		throw std::logic_error("Segment ends must differ");
+}
+
+template <typename T>
+const Point<T> Segment<T>::GetStart() const {
+	return Point<T>(x0_, y0_, z0_);
+}
+
+template <typename T>
+const Point<T> Segment<T>::GetEnd() const {
+	return Point<T>(x0_ + dx_, y0_ + dy_, z0_ + dz_);
+}
+
+template <typename T>
+const Point<T> Segment<T>::GetPointByParam(T param) const {
+	CURVES_PROFILE_COUNT(SegmentEval);
+	Point<T> ret(x0_ + param * dx_, y0_ + param * dy_, z0_ + param * dz_);
+	return ret;
+}
+
+template <typename T>
+void Segment<T>::GetPointsByParams(const T* params, std::size_t count, T* xs, T* ys, T* zs) const {
+	CURVES_PROFILE_COUNT_N(SegmentBatchPoint, count);
+	for (std::size_t i = 0; i < count; ++i) {
+		xs[i] = x0_ + params[i] * dx_;
+		ys[i] = y0_ + params[i] * dy_;
+		zs[i] = z0_ + params[i] * dz_;
+	}
+}
+
+template <typename T>
+const TriDvector<T> Segment<T>::GetDerivativeByParam(T /*param*/) const {
+	CURVES_PROFILE_COUNT(SegmentDeriv);
+	TriDvector<T> ret(dx_, dy_, dz_);
+	ret.Normalize();
+	return ret;
+}
+
+template <typename T>
+const bool Segment<T>::IsCircle() const {
+	return false;
+}
+
+template <typename T>
+const CurveKind Segment<T>::GetKind() const {
+	return CurveKind::Segment;
+}
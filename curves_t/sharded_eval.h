@@ -0,0 +1,410 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define CURVES_SHARDS_POSIX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#include "curve_store.h"
+
+// Sharded evaluation of a big CurveStore by several worker processes on one machine.
+//
+// Curve parameter rows (packed at each kind's own width) and output points (structure-of-arrays: xs, ys, zs, index = curve * samples + sample)
+// live in one POSIX shared memory block. Curves are grouped by kind, every group is cut into
+// shards of `curves_per_shard` curves times `param_splits` parameter sub-ranges.
+// Workers pull shards from a lock-free queue in the same block (an atomic cursor).
+// If a worker dies, the parent re-runs every shard that isn't marked done -
+// shards are idempotent, half-written output is simply overwritten.
+//
+// Without POSIX (Windows build) workers are threads over the same layout, so callers don't care.
+//
+// fork() copies only the calling thread: locks other threads held at that moment (TBB workers behind
+// std::execution::par, malloc arenas, stdio) stay locked forever in the child. So a forked worker runs plain code only -
+// atomics on the shared block, curve math on the stack, buffers the parent allocated before fork(), then _exit().
+// No allocation, no exceptions, no I/O, no parallel algorithms in WorkerLoop / RunShard; with that, Run() is safe
+// in a process that has already used parallel algorithms.
+//
+// Tests build with CURVES_SHARDS_FAULT_INJECTION defined to get SetCrashWorker() - a worker that dies on purpose.
+
+struct ShardOptions {
+	size_t workers = 4;
+	size_t curves_per_shard = 1024;
+	size_t param_splits = 1;
+	std::function<void(size_t done, size_t total)> progress;			// called from the parent while waiting
+};
+
+struct ShardReport {
+	size_t shards = 0;
+	size_t workers_started = 0;
+	size_t workers_failed = 0;
+	size_t shards_recovered = 0;			// re-run by the parent after a worker death
+};
+
+/*********************************** Implementation details ***************************************/
+
+namespace ShardDetail {
+
+	enum ShardState : uint32_t {
+		PENDING = 0,
+		RUNNING = 1,
+		DONE = 2
+	};
+
+	struct Shard {
+		uint64_t first;					// position in kind-sorted order
+		uint64_t count;
+		uint64_t sample_begin;
+		uint64_t sample_end;
+		uint64_t row;					// first curve's row in the packed rows - one kind, one width per shard
+		std::atomic<uint32_t> state;
+		std::atomic<int32_t> owner;		// worker index
+	};
+
+	struct Header {
+		uint64_t curves;
+		uint64_t samples;
+		uint64_t shards;
+		std::atomic<uint64_t> next_shard;		// queue cursor
+		std::atomic<uint64_t> shards_done;
+	};
+
+	static_assert(std::atomic<uint64_t>::is_always_lock_free, "shared memory queue needs lock-free atomics");
+	static_assert(std::atomic<uint32_t>::is_always_lock_free, "shared memory queue needs lock-free atomics");
+
+	inline size_t Align(size_t n) {
+		return (n + 63) & ~size_t(63);
+	}
+
+	// One contiguous block, shared between processes when POSIX is available
+	class SharedBlock {
+	private:		// fields
+		void* data_ = nullptr;
+		size_t size_ = 0;
+
+	public:			// constructors
+		SharedBlock() = delete;
+		explicit SharedBlock(size_t size) : size_(size) {
+#ifdef CURVES_SHARDS_POSIX
+			static std::atomic<unsigned> counter{ 0 };
+			const std::string name = "/curves_t_" + std::to_string(getpid()) + "_" + std::to_string(counter++);
+			const int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+			if (fd < 0)
+				throw std::runtime_error("shm_open failed");
+			shm_unlink(name.c_str());			// mapping survives, nothing leaks if we crash
+			if (ftruncate(fd, static_cast<off_t>(size_)) != 0) {
+				close(fd);
+				throw std::runtime_error("ftruncate of shared memory failed");
+			}
+			data_ = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+			close(fd);
+			if (data_ == MAP_FAILED) {
+				data_ = nullptr;
+				throw std::runtime_error("mmap of shared memory failed");
+			}
+#else
+			data_ = ::operator new(size_, std::align_val_t(64));
+			std::memset(data_, 0, size_);
+#endif
+		}
+
+		SharedBlock(const SharedBlock&) = delete;
+		SharedBlock& operator=(const SharedBlock&) = delete;
+
+		~SharedBlock() {
+#ifdef CURVES_SHARDS_POSIX
+			if (data_)
+				munmap(data_, size_);
+#else
+			::operator delete(data_, std::align_val_t(64));
+#endif
+		}
+
+	public:			// methods
+		char* Data() const { return static_cast<char*>(data_); }
+	};
+
+}		// namespace ShardDetail
+
+template <typename T>
+class ShardedEvaluator {
+private:			// fields
+	const size_t curves_;
+	const size_t samples_;
+	const T t0_;
+	const T step_;
+	const ShardOptions options_;
+
+	std::unique_ptr<ShardDetail::SharedBlock> block_;
+	ShardDetail::Header* header_ = nullptr;
+	ShardDetail::Shard* shards_ = nullptr;
+	uint64_t* order_ = nullptr;				// sorted position -> original curve index
+	uint32_t* kinds_ = nullptr;				// in sorted order
+	T* rows_ = nullptr;						// ParamCount(kind) values per curve, sorted order
+	T* xs_ = nullptr;						// outputs, original curve order
+	T* ys_ = nullptr;
+	T* zs_ = nullptr;
+#ifdef CURVES_SHARDS_FAULT_INJECTION
+	int crash_worker_ = -1;
+#endif
+
+public:				// constructors
+	ShardedEvaluator() = delete;
+	// `samples` points spread evenly over [t0, t1] (ends included) for every curve
+	ShardedEvaluator(const CurveStore<T>& store, T t0, T t1, size_t samples, ShardOptions options = ShardOptions());
+
+	ShardedEvaluator(const ShardedEvaluator&) = delete;
+	ShardedEvaluator& operator=(const ShardedEvaluator&) = delete;
+
+public:				// methods
+	ShardReport Run();
+
+	const size_t GetShardCount() const;
+	const T* GetXs() const;
+	const T* GetYs() const;
+	const T* GetZs() const;
+	const Point<T> GetPoint(size_t curve, size_t sample) const;
+
+#ifdef CURVES_SHARDS_FAULT_INJECTION
+	// Test seam: this worker dies right after claiming its first shard
+	void SetCrashWorker(int worker) { crash_worker_ = worker; }
+#endif
+
+private:
+	// params: room for `samples` values, owned by the caller - nothing is allocated here
+	void WorkerLoop(int worker, T* params);
+	void RunShard(size_t id, T* params);
+};
+
+/****************************************** DEFINITIONS ************************************************/
+
+template <typename T>
+ShardedEvaluator<T>::ShardedEvaluator(const CurveStore<T>& store, T t0, T t1, size_t samples, ShardOptions options)
+	: curves_(store.Size()), samples_(samples), t0_(t0),
+	step_(samples > 1 ? (t1 - t0) / static_cast<T>(samples - 1) : 0), options_(std::move(options)) {
+	using namespace ShardDetail;
+	if (options_.curves_per_shard == 0 || options_.param_splits == 0)
+		throw std::logic_error("Shard sizes must be positive");
+
+	// group by kind - one shard runs one kind's code path only
+	std::vector<uint64_t> order(curves_);
+	for (size_t i = 0; i < curves_; ++i)
+		order[i] = i;
+	std::stable_sort(order.begin(), order.end(), [&store](uint64_t a, uint64_t b) {
+		return store.GetKind(a) < store.GetKind(b);
+	});
+
+	struct Plan { uint64_t first, count, sample_begin, sample_end, row; };
+	std::vector<Plan> plan;
+	const size_t splits = std::min(options_.param_splits, std::max<size_t>(samples_, 1));
+	size_t row_values = 0;
+	for (size_t group = 0; group < curves_;) {
+		size_t group_end = group;
+		while (group_end < curves_ && store.GetKind(order[group_end]) == store.GetKind(order[group]))
+			++group_end;
+		const size_t width = CurveStore<T>::ParamCount(store.GetKind(order[group]));
+		for (size_t first = group; first < group_end; first += options_.curves_per_shard) {
+			const size_t count = std::min(options_.curves_per_shard, group_end - first);
+			const size_t row = row_values + (first - group) * width;
+			for (size_t s = 0; s < splits; ++s)
+				plan.push_back({ first, count, samples_ * s / splits, samples_ * (s + 1) / splits, row });
+		}
+		row_values += (group_end - group) * width;
+		group = group_end;
+	}
+
+	const size_t points = curves_ * samples_;
+	const size_t header_size = Align(sizeof(Header));
+	const size_t shards_size = Align(sizeof(Shard) * plan.size());
+	const size_t order_size = Align(sizeof(uint64_t) * curves_);
+	const size_t kinds_size = Align(sizeof(uint32_t) * curves_);
+	const size_t rows_size = Align(sizeof(T) * row_values);
+	const size_t out_size = Align(sizeof(T) * points);
+	block_ = std::make_unique<SharedBlock>(header_size + shards_size + order_size + kinds_size + rows_size + 3 * out_size);
+
+	char* p = block_->Data();
+	header_ = new (p) Header{ curves_, samples_, plan.size(), {0}, {0} };
+	p += header_size;
+	shards_ = reinterpret_cast<Shard*>(p);
+	for (size_t i = 0; i < plan.size(); ++i)
+		new (shards_ + i) Shard{ plan[i].first, plan[i].count, plan[i].sample_begin, plan[i].sample_end, plan[i].row, {PENDING}, {-1} };
+	p += shards_size;
+	order_ = reinterpret_cast<uint64_t*>(p);
+	p += order_size;
+	kinds_ = reinterpret_cast<uint32_t*>(p);
+	p += kinds_size;
+	rows_ = reinterpret_cast<T*>(p);
+	p += rows_size;
+	xs_ = reinterpret_cast<T*>(p);
+	ys_ = reinterpret_cast<T*>(p + out_size);
+	zs_ = reinterpret_cast<T*>(p + 2 * out_size);
+
+	T row[CurveStore<T>::PARAMS];
+	for (size_t i = 0, at = 0; i < curves_; ++i) {
+		order_[i] = order[i];
+		const CurveKind kind = store.GetKind(order[i]);
+		kinds_[i] = static_cast<uint32_t>(kind);
+		const size_t width = CurveStore<T>::ParamCount(kind);
+		store.GetRow(order[i], row);
+		std::copy(row, row + width, rows_ + at);
+		at += width;
+	}
+}
+
+template <typename T>
+void ShardedEvaluator<T>::RunShard(size_t id, T* params) {
+	const ShardDetail::Shard& sh = shards_[id];
+	const size_t n = sh.sample_end - sh.sample_begin;
+	for (size_t s = 0; s < n; ++s)
+		params[s] = t0_ + step_ * static_cast<T>(sh.sample_begin + s);
+	const CurveKind kind = static_cast<CurveKind>(kinds_[sh.first]);
+	const size_t width = CurveStore<T>::ParamCount(kind);
+	T row[CurveStore<T>::PARAMS] = {};
+	for (size_t pos = sh.first; pos < sh.first + sh.count; ++pos) {
+		const T* packed = rows_ + sh.row + (pos - sh.first) * width;
+		std::copy(packed, packed + width, row);
+		const size_t out = order_[pos] * samples_ + sh.sample_begin;
+		CurveStore<T>::Evaluate(kind, row, params, n, xs_ + out, ys_ + out, zs_ + out);
+	}
+}
+
+template <typename T>
+void ShardedEvaluator<T>::WorkerLoop(int worker, T* params) {
+	using namespace ShardDetail;
+	for (;;) {
+		const uint64_t id = header_->next_shard.fetch_add(1);
+		if (id >= header_->shards)
+			return;
+		shards_[id].owner.store(worker);
+		shards_[id].state.store(RUNNING);
+#if defined(CURVES_SHARDS_POSIX) && defined(CURVES_SHARDS_FAULT_INJECTION)
+		if (worker == crash_worker_)
+			_exit(3);
+#endif
+		RunShard(id, params);
+		shards_[id].state.store(DONE);
+		header_->shards_done.fetch_add(1);
+	}
+}
+
+template <typename T>
+ShardReport ShardedEvaluator<T>::Run() {
+	using namespace ShardDetail;
+	ShardReport report;
+	report.shards = header_->shards;
+	auto report_progress = [this]() {
+		if (options_.progress)
+			options_.progress(header_->shards_done.load(), header_->shards);
+	};
+
+	// parameter buffers of every worker plus the parent's recovery lane, all allocated up front
+	const size_t lane = std::max<size_t>(samples_, 1);
+	std::vector<T> scratch(lane * (options_.workers + 1));
+	T* const recovery = scratch.data() + lane * options_.workers;
+
+#ifdef CURVES_SHARDS_POSIX
+#ifdef CURVES_PROFILE
+	CurvesProfile::Registry::Get();			// counters' static is created here, not behind a guard lock in a child
+#endif
+	std::vector<pid_t> pids;
+	for (size_t w = 0; w < options_.workers; ++w) {
+		const pid_t pid = fork();
+		if (pid == 0) {
+			WorkerLoop(static_cast<int>(w), scratch.data() + lane * w);
+			_exit(0);			// no destructors, no atexit handlers of the parent
+		}
+		if (pid > 0)
+			pids.push_back(pid);
+	}
+	report.workers_started = pids.size();
+	// only our own workers are waited for - other children of the host process keep their exit statuses.
+	// Recovery below must not start before every worker is gone, they write into the same block
+	std::vector<bool> reaped(pids.size(), false);
+	size_t alive = pids.size();
+	while (alive > 0) {
+		for (size_t w = 0; w < pids.size(); ++w) {
+			if (reaped[w])
+				continue;
+			int status = 0;
+			const pid_t pid = waitpid(pids[w], &status, WNOHANG);
+			if (pid == 0)
+				continue;			// still running
+			if (pid < 0 && errno == EINTR)
+				continue;
+			reaped[w] = true;
+			--alive;
+			if (pid < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+				++report.workers_failed;
+		}
+		if (alive > 0) {
+			report_progress();
+			std::this_thread::sleep_for(std::chrono::milliseconds(5));
+		}
+	}
+#else
+	std::vector<std::thread> threads;
+	for (size_t w = 0; w < options_.workers; ++w)
+		threads.emplace_back([this, w, &scratch, lane] { WorkerLoop(static_cast<int>(w), scratch.data() + lane * w); });
+	report.workers_started = threads.size();
+	while (header_->shards_done.load() < header_->shards) {
+		report_progress();
+		std::this_thread::sleep_for(std::chrono::milliseconds(5));
+	}
+	for (std::thread& t : threads)
+		t.join();
+#endif
+
+	// recovery: whatever is not done (claimed by a dead worker or never claimed) runs here
+	for (size_t id = 0; id < header_->shards; ++id) {
+		if (shards_[id].state.load() == DONE)
+			continue;
+		RunShard(id, recovery);
+		shards_[id].state.store(DONE);
+		header_->shards_done.fetch_add(1);
+		++report.shards_recovered;
+	}
+	report_progress();
+	return report;
+}
+
+template <typename T>
+const size_t ShardedEvaluator<T>::GetShardCount() const {
+	return header_->shards;
+}
+
+template <typename T>
+const T* ShardedEvaluator<T>::GetXs() const {
+	return xs_;
+}
+
+template <typename T>
+const T* ShardedEvaluator<T>::GetYs() const {
+	return ys_;
+}
+
+template <typename T>
+const T* ShardedEvaluator<T>::GetZs() const {
+	return zs_;
+}
+
+template <typename T>
+const Point<T> ShardedEvaluator<T>::GetPoint(size_t curve, size_t sample) const {
+	const size_t i = curve * samples_ + sample;
+	return Point<T>(xs_[i], ys_[i], zs_[i]);
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+#include "curve.h"
+#include "curve_store.h"
+
+// Indices of the store curves of one kind, ordered by one parameter column -
+// e.g. circles by radius, as main() sorts them. Kept across frames: after ApplyDeltas
+// Update() repairs the previous order with insertion sort, O(n + moved distance) instead of a full sort.
+// Curves added to the store meanwhile are sorted on their own and merged in
+template <typename T>
+class SortedView {
+private:			// fields
+	CurveKind kind_;
+	size_t column_;
+	size_t scanned_ = 0;					// store rows already looked at
+	std::vector<size_t> order_;
+
+public:				// constructors
+	SortedView() = delete;
+	explicit SortedView(const CurveStore<T>& store, CurveKind kind, size_t column);
+
+public:				// methods
+	// Restores the order after parameter changes and picks up curves added to the store since the last call
+	void Update(const CurveStore<T>& store);
+
+	const std::vector<size_t>& GetOrder() const;
+	const size_t Size() const;
+};
+
+/****************************************** DEFINITIONS ************************************************/
+
+template <typename T>
+SortedView<T>::SortedView(const CurveStore<T>& store, CurveKind kind, size_t column) : kind_(kind), column_(column) {
+	if (column >= CurveStore<T>::COLUMNS)
+		throw std::logic_error("CurveStore index out of range");
+	Update(store);
+}
+
+// Stable: equal keys keep their previous relative order, so the view doesn't flicker between frames
+template <typename T>
+void SortedView<T>::Update(const CurveStore<T>& store) {
+	if (store.Size() < scanned_)
+		throw std::logic_error("SortedView store shrank");
+	const T* key = store.GetColumn(column_);
+	auto less = [key](size_t lhs, size_t rhs) { return key[lhs] < key[rhs]; };
+
+	// previous order is nearly sorted after small deltas - insertion sort
+	for (size_t i = 1; i < order_.size(); ++i) {
+		const size_t cur = order_[i];
+		size_t j = i;
+		for (; j > 0 && less(cur, order_[j - 1]); --j)
+			order_[j] = order_[j - 1];
+		order_[j] = cur;
+	}
+
+	// new curves are in no particular order - full sort of them, then merge
+	const size_t old = order_.size();
+	for (; scanned_ < store.Size(); ++scanned_)
+		if (store.GetKind(scanned_) == kind_)
+			order_.push_back(scanned_);
+	std::stable_sort(order_.begin() + old, order_.end(), less);
+	std::inplace_merge(order_.begin(), order_.begin() + old, order_.end(), less);
+}
+
+template <typename T>
+const std::vector<size_t>& SortedView<T>::GetOrder() const {
+	return order_;
+}
+
+template <typename T>
+const size_t SortedView<T>::Size() const {
+	return order_.size();
+}
@@ -7,10 +7,18 @@
 #include <iostream>
 
 #include "curve.h"
+#include "curve_store.h"
+#include "sorted_view.h"
+#include "metrics.h"
+#include "profiler.h"
 #include "tests.h"
+#include "benchmarks.h"
 
 int main() {
 	MyUnitTests::RunTests();
+#ifdef CURVES_BENCHMARKS
+	MyBenchmarks::RunBenchmarks();
+#endif
 
 	std::random_device rd;
 	std::mt19937 gen(rd());
@@ -43,6 +51,8 @@ int main() {
 
 	std::shuffle(v1.begin(), v1.end(), gen);
 
+	{
+	CURVES_PROFILE_SCOPE("main::print_points");
 	std::for_each(
 		std::execution::seq,
 		v1.begin(), v1.end(),
@@ -51,32 +61,33 @@ int main() {
 			p.PrintOut();
 		}
 	);
+	}
 
-	std::vector<Circle<double>*> v2;
-	std::for_each(							// populate second container
-		std::execution::par,
-		v1.begin(), v1.end(),
-		[&v2](Curve<double>* cur) { 
-			if (cur->IsCircle())
-				v2.push_back(static_cast<Circle<double>*>(&*cur));
-		}
-	);
+	CurveStore<double> store;
+	{
+	CURVES_PROFILE_SCOPE("main::collect_circles");
+	store = CurveStore<double>::FromCurves(v1);		// flat copy - circle radii end up in column 0
+	}
 
-	std::sort(								// sort by radiis - from less to greater
-		v2.begin(), v2.end(),
-		[](const Circle<double>* lhs, const Circle<double>* rhs) { 
-			return lhs->GetRad() < rhs->GetRad();
-		}
-	);
+	std::vector<double> radii;
+	{
+	CURVES_PROFILE_SCOPE("main::sort_circles");
+	// by radii - from less to greater. An animation loop keeps the view and calls Update() after ApplyDeltas
+	// to repair the order instead of sorting again
+	const SortedView<double> circles(store, CurveKind::Circle, 0);
+	const double* rad = store.GetColumn(0);
+	radii.reserve(circles.Size());
+	for (size_t index : circles.GetOrder())
+		radii.push_back(rad[index]);
+	}
 
 	double total_sum = 0.0;
-	std::for_each(							// std::accumulate doesn't fit...
-		std::execution::par,
-		v2.begin(), v2.end(),
-		[&total_sum](const Circle<double>* cur) {
-			total_sum += cur->GetRad();
-		}			
-	);
+	{
+	CURVES_PROFILE_SCOPE("main::sum_radii");
+	total_sum = DeterministicSum(radii);		// parallel, but same bits every run
+	}
+
+	CURVES_PROFILE_EXPORT_JSON("curves_profile.json");
 
 	return 0;
 }
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include <string>
 #include <iostream>
 #include <cstring>              // for strcmp in throw-catch message check
+#include <limits>
 
 #include "curve.h"
 #include "circle.h"
@@ -11,6 +12,22 @@
 #include "point.h"
 #include "3Dvector.h"
 #include "helix.h"
+#include "intersection.h"
+#include "generator.h"
+#include "bulk.h"
+#include "metrics.h"
+#include "curve_store.h"
+#include "sharded_eval.h"
+#include "pipeline.h"
+#include "evaluator.h"
+#include "segment.h"
+#include "arc.h"
+#include "elliptic_helix.h"
+#include "conical_spiral.h"
+#include "bezier.h"
+#include "bspline.h"
+#include "polyline_codec.h"
+#include "sorted_view.h"
 
 namespace MyUnitTests {
 
@@ -464,6 +481,742 @@ namespace MyUnitTests {
         }
     }
 
+    void HelixLargeParam() {
+        {       // thousands of turns: z must grow by exactly one step per turn
+            Helix<double> h(3.0, 0.25);
+            const double turns = 123456;
+            const Point<double> getted = h.GetPointByParam(2 * PI * turns + PI / 3);
+            Point<double> correct(1.5, 3.0 * std::sqrt(3.0) / 2, 0.25 * turns + 0.25 / 6);
+            ASSERT_EQUAL_HINT(getted, correct, "Deep helix point lost precision");
+        }
+        {       // negative turns
+            Helix<double> h(1.0, 2.0);
+            const Point<double> getted = h.GetPointByParam(-2 * PI * 5000 - PI / 2);
+            Point<double> correct(0, -1, -2.0 * 5000 - 0.5);
+            ASSERT_EQUAL_HINT(getted, correct, "Negative deep helix point lost precision");
+        }
+        {       // a million turns against a long double reference - reducing by the rounded TWO_PI alone is ~1e-10 off there
+            if (std::numeric_limits<long double>::digits > std::numeric_limits<double>::digits) {
+                const long double two_pi = 6.28318530717958647692528676655900577L;
+                for (double param : { 2 * PI * 1e6 + 1.0, -2 * PI * 1e6 + 0.5, 2 * PI * 1e6 - 3.0 }) {
+                    double angle;
+                    const double turns = RangeReduction::ReduceTurns(param, angle);
+                    const long double reference = param - static_cast<long double>(turns) * two_pi;
+                    ASSERT_EQUAL_HINT(std::fabs(turns), 1e6, "Wrong number of turns");
+                    ASSERT_HINT(std::fabs(angle - reference) < 1e-12, "Reduced angle of a million turns lost precision");
+                }
+            }
+        }
+        {       // batch output equals single point evaluation for every curve kind
+            Circle<double> c(2.0);
+            Ellipsis<double> e(3.0, 1.5);
+            Helix<double> h(4.0, 7.0);
+            const Curve<double>* curves[] = { &c, &e, &h };
+            const double params[] = { 0.0, 1.0, -3.5, 1e3, 6.3e5 };
+            double xs[5], ys[5], zs[5];
+            for (const Curve<double>* cur : curves) {
+                cur->GetPointsByParams(params, 5, xs, ys, zs);
+                for (int i = 0; i < 5; ++i)
+                    ASSERT_EQUAL_HINT(Point<double>(xs[i], ys[i], zs[i]), cur->GetPointByParam(params[i]), "Batch point differs from single evaluation");
+            }
+        }
+    }
+
+    void IntersectionCurvePlane() {
+        {       // circle r=2 against x = 1 -> t = +-PI/3
+            Circle<double> c(2.0);
+            Plane<double> pl(1, 0, 0, 1);
+            std::vector<double> getted = IntersectPlane(c, pl, 0.0, 2 * PI);
+            ASSERT_EQUAL_HINT(getted.size(), 2u, "Circle must cross x = 1 twice per turn");
+            ASSERT_HINT(std::fabs(getted[0] - PI / 3) < DELTA, "Wrong first circle-plane root");
+            ASSERT_HINT(std::fabs(getted[1] - 5 * PI / 3) < DELTA, "Wrong second circle-plane root");
+        }
+        {       // tangent contact - sampling misses it
+            Ellipsis<double> e(3.0, 1.0);
+            Plane<double> pl(0, 1, 0, 1);
+            std::vector<double> getted = IntersectPlane(e, pl, 0.0, 2 * PI);
+            ASSERT_EQUAL_HINT(getted.size(), 1u, "Ellipsis tangent to y = 1 must touch once");
+            ASSERT_HINT(std::fabs(getted[0] - PI / 2) < DELTA, "Wrong ellipsis tangent root");
+        }
+        {       // helix against horizontal plane - exactly one root at z = 5
+            Helix<double> h(1.0, 2.0);
+            Plane<double> pl(0, 0, 1, 5);
+            std::vector<double> getted = IntersectPlane(h, pl, 0.0, 20 * PI);
+            ASSERT_EQUAL_HINT(getted.size(), 1u, "Helix crosses z = const once");
+            ASSERT_HINT(std::fabs(h.GetPointByParam(getted[0]).GetZ() - 5.0) < DELTA, "Helix-plane root is not on the plane");
+            ASSERT_HINT(std::fabs(getted[0] - 5 * PI) < DELTA, "Wrong helix-plane root");
+        }
+        {       // slanted plane crossing the helix on many turns
+            Helix<double> h(3.0, 0.5);
+            Plane<double> pl(1, 0, 0.2, 1);
+            std::vector<double> getted = IntersectPlane(h, pl, 0.0, 10 * PI);
+            ASSERT_HINT(getted.size() >= 8, "Slanted plane must cross the helix on every turn");
+            for (double t : getted)
+                ASSERT_HINT(std::fabs(pl.Eval(h.GetPointByParam(t))) < DELTA, "Helix-plane root is not on the plane");
+        }
+        {       // batch API goes through the same dispatch
+            Circle<double> c(2.0);
+            Helix<double> h(1.0, 2.0);
+            std::vector<Curve<double>*> curves{ &c, &h };
+            auto getted = IntersectPlane(curves, Plane<double>(0, 0, 1, 5), 0.0, 20 * PI);
+            ASSERT_EQUAL_HINT(getted[0].size(), 0u, "Circle lies in z = 0, can't hit z = 5");
+            ASSERT_EQUAL_HINT(getted[1].size(), 1u, "Batch helix-plane result differs");
+        }
+    }
+
+    void IntersectionCurveCurve() {
+        {       // circle r=2 and ellipsis 4x1 cross 4 times
+            Circle<double> c(2.0);
+            Ellipsis<double> e(4.0, 1.0);
+            auto getted = IntersectCurves<double>(c, 0, 2 * PI, e, 0, 2 * PI);
+            ASSERT_EQUAL_HINT(getted.size(), 4u, "Circle and ellipsis must cross 4 times");
+            for (const auto& [s, t] : getted)
+                ASSERT_EQUAL_HINT(c.GetPointByParam(s), e.GetPointByParam(t), "Curve-curve hit is not a common point");
+        }
+        {       // tangent contact of nested circle and ellipsis
+            Circle<double> c(1.0);
+            Ellipsis<double> e(1.0, 0.5);
+            auto getted = IntersectCurves<double>(c, 0, 2 * PI, e, 0, 2 * PI);
+            // contacts at s = t = 0 and s = t = PI; 0 and 2*PI are both in range, so (1, 0) may come as several pairs
+            bool right = false;
+            bool left = false;
+            for (const auto& [s, t] : getted) {
+                const double ws = std::remainder(s, 2 * PI);
+                const double wt = std::remainder(t, 2 * PI);
+                const bool at_right = std::fabs(ws) < DELTA && std::fabs(wt) < DELTA;
+                const bool at_left = std::fabs(std::fabs(ws) - PI) < DELTA && std::fabs(std::fabs(wt) - PI) < DELTA;
+                ASSERT_HINT(at_right || at_left, "Tangent contact found at a wrong parameter");
+                right |= at_right;
+                left |= at_left;
+            }
+            ASSERT_HINT(right && left, "Tangent contacts at (+-1, 0) are missed");
+        }
+        {       // disjoint curves
+            Circle<double> c(1.0);
+            Circle<double> c1(2.0);
+            auto getted = IntersectCurves<double>(c, 0, 2 * PI, c1, 0, 2 * PI);
+            ASSERT_EQUAL_HINT(getted.size(), 0u, "Concentric circles don't intersect");
+        }
+    }
+
+    void LazyPointChunks() {
+        {       // chunks cover all samples, last one is partial
+            Circle<double> c(1.0);
+            size_t chunks = 0;
+            size_t points = 0;
+            for (const std::vector<Point<double>>& chunk : SampleChunks(c, 0.0, 2 * PI, 10, 4)) {
+                ++chunks;
+                points += chunk.size();
+            }
+            ASSERT_EQUAL_HINT(chunks, 3u, "10 points by 4 must give 3 chunks");
+            ASSERT_EQUAL_HINT(points, 10u, "Chunks lost points");
+        }
+        {       // flattened samples are the same as direct evaluation, both ends included
+            Helix<double> h(2.0, 3.0);
+            std::vector<Point<double>> direct;
+            for (int i = 0; i < 7; ++i)
+                direct.push_back(h.GetPointByParam(PI * i / 6));
+            size_t i = 0;
+            for (const Point<double>& p : SamplePoints(h, 0.0, PI, 7, 3)) {
+                ASSERT_HINT(i < direct.size(), "Too many lazy samples");
+                ASSERT_EQUAL_HINT(p, direct[i], "Lazy sample differs from GetPointByParam");
+                ++i;
+            }
+            ASSERT_EQUAL_HINT(i, direct.size(), "Lazy samples lost points");
+        }
+        {       // composes with std::ranges views: sample -> filter -> transform
+            Circle<double> c(2.0);
+            auto upper_x = SamplePoints(c, 0.0, 2 * PI, 1001, 64)
+                | std::views::filter([](const Point<double>& p) { return p.GetY() > DELTA; })
+                | std::views::transform([](const Point<double>& p) { return p.GetX(); });
+            size_t count = 0;
+            for (double x : upper_x) {
+                ASSERT_HINT(std::fabs(x) <= 2.0, "Transformed coordinate out of circle");
+                ++count;
+            }
+            ASSERT_EQUAL_HINT(count, 499u, "Wrong number of points with y > 0");
+        }
+    }
+
+    void BulkConstruction() {
+        {       // bad records are skipped and reported, no exception
+            const double nan = std::numeric_limits<double>::quiet_NaN();
+            const double inf = std::numeric_limits<double>::infinity();
+            std::vector<double> rads{ 1.0, -2.0, 3.0, 0.0, nan, inf, 7.0 };
+            std::vector<Circle<double>> circles;
+            BulkReport report = BuildCircles(rads, circles);
+            ASSERT_EQUAL_HINT(report.GetTotal(), 7u, "Wrong bulk total");
+            ASSERT_EQUAL_HINT(report.GetInvalidCount(), 4u, "Wrong bulk invalid count");
+            ASSERT_EQUAL_HINT(circles.size(), 3u, "Only valid circles must be constructed");
+            ASSERT_EQUAL_HINT(circles[2].GetRad(), 7.0, "Valid circles must keep input order");
+            std::vector<size_t> bad = report.GetInvalidIndices();
+            std::vector<size_t> correct{ 1, 3, 4, 5 };
+            ASSERT_HINT(bad == correct, "Wrong invalid indices");
+        }
+        {       // mask spans several words
+            std::vector<double> rads(200, 1.0);
+            std::vector<double> steps(200, 0.5);
+            rads[63] = -1;
+            steps[64] = std::numeric_limits<double>::infinity();
+            rads[199] = 0;
+            std::vector<Helix<double>> helices;
+            BulkReport report = BuildHelices(rads, steps, helices);
+            ASSERT_EQUAL_HINT(helices.size(), 197u, "Wrong number of valid helices");
+            ASSERT_HINT(!report.IsValid(63) && !report.IsValid(64) && !report.IsValid(199), "Invalid helices not marked");
+            ASSERT_HINT(report.IsValid(0) && report.IsValid(65) && report.IsValid(198), "Valid helices marked invalid");
+        }
+        {
+            std::vector<Ellipsis<double>> ellipses;
+            BulkReport report = BuildEllipses(std::vector<double>{ 1, 2, 3 }, std::vector<double>{ 1, -2, 3 }, ellipses);
+            ASSERT_EQUAL_HINT(ellipses.size(), 2u, "Wrong number of valid ellipses");
+            ASSERT_HINT(!report.IsValid(1), "Ellipsis with negative radius not marked");
+        }
+        {       // bulk skips a record exactly when its constructor throws
+            const double nan = std::numeric_limits<double>::quiet_NaN();
+            const double inf = std::numeric_limits<double>::infinity();
+            const std::vector<double> values{ 1.0, -2.0, 0.0, nan, inf, -inf, std::numeric_limits<double>::max() };
+            auto throws = [](auto&& make) {
+                try {
+                    make();
+                    return false;
+                }
+                catch (const std::logic_error&) {
+                    return true;
+                }
+            };
+            for (double a : values) {
+                std::vector<Circle<double>> circles;
+                const bool circle_bad = !BuildCircles(std::vector<double>{ a }, circles).IsValid(0);
+                ASSERT_EQUAL_HINT(circle_bad, throws([a] { Circle<double> c(a); }), "Bulk and Circle constructor disagree");
+                for (double b : values) {
+                    std::vector<Ellipsis<double>> ellipses;
+                    const bool ellipsis_bad = !BuildEllipses(std::vector<double>{ a }, std::vector<double>{ b }, ellipses).IsValid(0);
+                    ASSERT_EQUAL_HINT(ellipsis_bad, throws([a, b] { Ellipsis<double> e(a, b); }), "Bulk and Ellipsis constructor disagree");
+                    std::vector<Helix<double>> helices;
+                    const bool helix_bad = !BuildHelices(std::vector<double>{ a }, std::vector<double>{ b }, helices).IsValid(0);
+                    ASSERT_EQUAL_HINT(helix_bad, throws([a, b] { Helix<double> h(a, b); }), "Bulk and Helix constructor disagree");
+                }
+            }
+            try {
+                Circle<double> c(inf);
+                ASSERT_HINT(false, "No exception by Circle with infinite radius\n");
+            }
+            catch (const std::logic_error& e) {
+                if (std::strcmp(e.what(), "Curve parameters must be finite") != 0)
+                    throw;
+            }
+        }
+    }
+
+    void CurveMetrics() {
+        {
+            Circle<double> c(2.0);
+            ASSERT_HINT(std::fabs(Length(c) - 4 * PI) < DELTA, "Wrong circle length");
+            ASSERT_HINT(std::fabs(Area(c) - 4 * PI) < DELTA, "Wrong circle area");
+        }
+        {       // Ramanujan's formula is exact for a circle, close for 2:1
+            Ellipsis<double> round(3.0, 3.0);
+            ASSERT_HINT(std::fabs(Length(round) - 6 * PI) < DELTA, "Ellipsis with equal radii must have circle length");
+            Ellipsis<double> e(2.0, 1.0);
+            ASSERT_HINT(std::fabs(Length(e) - 9.688448220547675) < DELTA, "Wrong ellipsis length");
+            ASSERT_HINT(std::fabs(Area(e) - 2 * PI) < DELTA, "Wrong ellipsis area");
+        }
+        {       // helix: 3 turns of radius 1 and step 2
+            Helix<double> h(1.0, 2.0);
+            ASSERT_HINT(std::fabs(Height(h, 0.0, 6 * PI) - 6.0) < DELTA, "Wrong helix height");
+            ASSERT_HINT(std::fabs(Length(h, 0.0, 6 * PI) - 3 * std::sqrt(4 * PI * PI + 4)) < DELTA, "Wrong helix length");
+            Bounds<double> b = BoundingBox(h, 0.0, PI / 2);			// quarter turn: x, y in [0, 1]
+            ASSERT_HINT(std::fabs(b.lo[0]) < DELTA && std::fabs(b.hi[0] - 1) < DELTA, "Wrong partial helix x bounds");
+            ASSERT_HINT(std::fabs(b.lo[1]) < DELTA && std::fabs(b.hi[1] - 1) < DELTA, "Wrong partial helix y bounds");
+            ASSERT_HINT(std::fabs(b.hi[2] - 0.5) < DELTA, "Wrong partial helix z bounds");
+        }
+        {       // collection reduction
+            Circle<double> c(1.0);
+            Ellipsis<double> e(3.0, 1.0);
+            Helix<double> h(2.0, 4.0);
+            std::vector<Curve<double>*> curves{ &c, &e, &h };
+            CollectionMetrics<double> m = ComputeMetrics(curves, 0.0, 2 * PI);
+            ASSERT_HINT(std::fabs(m.total_area - (PI + 3 * PI)) < DELTA, "Wrong total area");
+            ASSERT_HINT(std::fabs(m.total_helix_height - 4.0) < DELTA, "Wrong total helix height");
+            ASSERT_HINT(std::fabs(m.total_length - (Length(c) + Length(e) + Length(h, 0.0, 2 * PI))) < DELTA, "Wrong total length");
+            ASSERT_HINT(std::fabs(m.bounds.lo[0] + 3) < DELTA && std::fabs(m.bounds.hi[1] - 2) < DELTA, "Wrong collection bounds");
+            ASSERT_HINT(std::fabs(m.bounds.hi[2] - 4) < DELTA, "Wrong collection z bound");
+        }
+        {       // same input, same bits
+            std::vector<double> values;
+            for (int i = 0; i < 100000; ++i)
+                values.push_back(1.0 / (i + 1));
+            const double first = DeterministicSum(values);
+            for (int run = 0; run < 5; ++run)
+                ASSERT_HINT(DeterministicSum(values) == first, "Parallel sum is not deterministic");
+        }
+    }
+
+    void CurveStoreEvaluation() {
+        {       // store evaluation is the object evaluation
+            Circle<double> c(2.0);
+            Ellipsis<double> e(3.0, 1.0);
+            Helix<double> h(1.5, 4.0);
+            std::vector<Curve<double>*> curves{ &c, &e, &h };
+            CurveStore<double> store = CurveStore<double>::FromCurves(curves);
+            ASSERT_EQUAL_HINT(store.Size(), 3u, "Wrong store size");
+            for (size_t i = 0; i < curves.size(); ++i) {
+                ASSERT_HINT(store.GetKind(i) == curves[i]->GetKind(), "Store lost curve kind");
+                ASSERT_EQUAL_HINT(store.GetPointByParam(i, 1.25), curves[i]->GetPointByParam(1.25), "Store point differs from curve point");
+                ASSERT_EQUAL_HINT(store.MakeCurve(i)->GetPointByParam(7.5), curves[i]->GetPointByParam(7.5), "Materialized curve differs");
+            }
+        }
+        {
+            CurveStore<double> store;
+            try {
+                store.AddHelix(-1.0, 2.0);
+                ASSERT_HINT(false, "No exception by CurveStore::AddHelix with radii <= 0\n");
+            }
+            catch (const std::logic_error& e) {
+                if (std::strcmp(e.what(), "Radii must be positive") != 0)
+                    throw;
+            }
+        }
+    }
+
+    void ShardedEvaluation() {
+        CurveStore<double> store;
+        for (int i = 0; i < 100; ++i) {
+            switch (i % 3) {
+            case 0: store.AddCircle(1.0 + i); break;
+            case 1: store.AddEllipsis(1.0 + i, 2.0); break;
+            default: store.AddHelix(1.0 + i, 0.5 * i); break;
+            }
+        }
+        const size_t samples = 33;
+        auto check = [&](const ShardedEvaluator<double>& eval) {
+            for (size_t c = 0; c < store.Size(); ++c)
+                for (size_t s = 0; s < samples; ++s)
+                    ASSERT_EQUAL_HINT(eval.GetPoint(c, s), store.GetPointByParam(c, 10.0 * s / (samples - 1)), "Sharded point differs from direct evaluation");
+        };
+        {
+            ShardOptions opt;
+            opt.workers = 3;
+            opt.curves_per_shard = 7;
+            opt.param_splits = 2;
+            size_t last_done = 0;
+            opt.progress = [&last_done](size_t done, size_t) { last_done = done; };
+            ShardedEvaluator<double> eval(store, 0.0, 10.0, samples, opt);
+            ShardReport report = eval.Run();
+            ASSERT_EQUAL_HINT(report.workers_failed, 0u, "Healthy workers reported as failed");
+            ASSERT_EQUAL_HINT(last_done, eval.GetShardCount(), "Progress didn't reach the end");
+            check(eval);
+        }
+#if defined(CURVES_SHARDS_POSIX) && defined(CURVES_SHARDS_FAULT_INJECTION)
+        {       // the only worker dies holding a shard - parent must finish all the work
+            ShardOptions opt;
+            opt.workers = 1;
+            opt.curves_per_shard = 5;
+            ShardedEvaluator<double> eval(store, 0.0, 10.0, samples, opt);
+            eval.SetCrashWorker(0);
+            ShardReport report = eval.Run();
+            ASSERT_EQUAL_HINT(report.workers_failed, 1u, "Dead worker not detected");
+            ASSERT_HINT(report.shards_recovered >= 1, "Shard of the dead worker not recovered");
+            check(eval);
+        }
+#endif
+    }
+
+    void StagePipeline() {
+        {       // ring keeps order and refuses overflow
+            SpscRing<int> ring(3);
+            ASSERT_EQUAL_HINT(ring.Capacity(), 4u, "Ring capacity must round up to a power of two");
+            for (int i = 0; i < 4; ++i) {
+                int v = i;
+                ASSERT_HINT(ring.TryPush(v), "Ring refused a push below capacity");
+            }
+            int extra = 4;
+            ASSERT_HINT(!ring.TryPush(extra), "Ring accepted a push over capacity");
+            for (int i = 0; i < 4; ++i) {
+                int v = -1;
+                ASSERT_HINT(ring.TryPop(v) && v == i, "Ring broke FIFO order");
+            }
+        }
+        {       // work -> sample -> frames -> transform -> sink gives the direct evaluation result
+            CurveStore<double> store;
+            store.AddCircle(2.0);
+            store.AddEllipsis(3.0, 1.0);
+            store.AddHelix(1.0, 4.0);
+            const size_t samples = 1000;
+            const std::array<double, 12> shift{ 1, 0, 0, 10,   0, 1, 0, 0,   0, 0, 1, -5 };
+
+            std::vector<std::vector<Point<double>>> got(store.Size());
+            size_t tangents_checked = 0;
+            Pipeline<CurveBatch<double>> pipe(4);
+            pipe.SetSource(PipelineStages::Work(store, 0.0, 2 * PI, samples, 64))
+                .AddStage(PipelineStages::Sample(store))
+                .AddStage(PipelineStages::Frames(store))
+                .AddStage(PipelineStages::Transform(shift))
+                .SetSink([&](CurveBatch<double>& b) {
+                    for (size_t i = 0; i < b.count; ++i) {
+                        got[b.curve].emplace_back(b.xs[i], b.ys[i], b.zs[i]);
+                        const TriDvector<double> d = store.GetDerivativeByParam(b.curve, b.params[i]);
+                        ASSERT_EQUAL_HINT(TriDvector<double>(b.tx[i], b.ty[i], b.tz[i]), d, "Pipeline frame differs");
+                        ++tangents_checked;
+                    }
+                });
+            std::vector<StageStats> stats = pipe.Run();
+            ASSERT_EQUAL_HINT(stats.size(), 5u, "Stats for every stage expected");
+            ASSERT_EQUAL_HINT(tangents_checked, 3 * samples, "Pipeline lost samples");
+            for (size_t c = 0; c < store.Size(); ++c) {
+                ASSERT_EQUAL_HINT(got[c].size(), samples, "Pipeline lost samples of a curve");
+                for (size_t s = 0; s < samples; ++s) {
+                    const Point<double> p = store.GetPointByParam(c, 2 * PI * s / (samples - 1));
+                    ASSERT_EQUAL_HINT(got[c][s], Point<double>(p.GetX() + 10, p.GetY(), p.GetZ() - 5), "Pipeline point differs");
+                }
+            }
+        }
+        {       // stage failure stops everything and reaches the caller
+            Pipeline<int> pipe(2);
+            int produced = 0;
+            pipe.SetSource([&produced](int& v) { v = produced++; return true; })      // endless
+                .SetSink([](int& v) { if (v == 100) throw std::runtime_error("sink failed"); });
+            try {
+                pipe.Run();
+                ASSERT_HINT(false, "Pipeline swallowed a stage exception");
+            }
+            catch (const std::runtime_error& e) {
+                ASSERT_HINT(std::strcmp(e.what(), "sink failed") == 0, "Wrong exception from pipeline");
+            }
+        }
+    }
+
+    void PrecomputedEvaluators() {
+        {       // same points and tangents as the curve objects
+            Circle<double> c(2.0);
+            Ellipsis<double> e(3.0, 1.5);
+            Helix<double> h(4.0, 7.0);
+            const CircleEvaluator<double> ce = MakeEvaluator(c);
+            const EllipsisEvaluator<double> ee = MakeEvaluator(e);
+            const HelixEvaluator<double> he = MakeEvaluator(h);
+            const double params[] = { 0.0, PI / 3, -2.5, 1e3, -6.3e5 };
+            double x, y, z;
+            for (double t : params) {
+                ce.GetPoint(t, x, y, z);
+                ASSERT_EQUAL_HINT(Point<double>(x, y, z), c.GetPointByParam(t), "Circle evaluator point differs");
+                ce.GetTangent(t, x, y, z);
+                ASSERT_EQUAL_HINT(Point<double>(x, y, z), c.GetDerivativeByParam(t).MakePoint(), "Circle evaluator tangent differs");
+                ee.GetPoint(t, x, y, z);
+                ASSERT_EQUAL_HINT(Point<double>(x, y, z), e.GetPointByParam(t), "Ellipsis evaluator point differs");
+                ee.GetTangent(t, x, y, z);
+                ASSERT_EQUAL_HINT(Point<double>(x, y, z), e.GetDerivativeByParam(t).MakePoint(), "Ellipsis evaluator tangent differs");
+                he.GetPoint(t, x, y, z);
+                ASSERT_EQUAL_HINT(Point<double>(x, y, z), h.GetPointByParam(t), "Helix evaluator point differs");
+                he.GetTangent(t, x, y, z);
+                ASSERT_EQUAL_HINT(Point<double>(x, y, z), h.GetDerivativeByParam(t).MakePoint(), "Helix evaluator tangent differs");
+            }
+        }
+        {       // helix tangent is unit length with a constant z component
+            const HelixEvaluator<double> he = MakeEvaluator(Helix<double>(2 * PI, 1.0));      // tangent (-sin, cos, 1)
+            double x, y, z;
+            he.GetTangent(1.0, x, y, z);
+            ASSERT_HINT(std::fabs(x * x + y * y + z * z - 1) < DELTA, "Helix evaluator tangent is not normalized");
+            ASSERT_HINT(std::fabs(z - 1 / std::sqrt(2.0)) < DELTA, "Wrong helix evaluator tangent slope");
+        }
+    }
+
+    void ExtraPrimitives() {
+        {       // analytic points and tangents
+            Segment<double> seg(Point<double>(0, 0, 0), Point<double>(4, 8, 0));
+            ASSERT_EQUAL_HINT(seg.GetPointByParam(0.25), Point<double>(1, 2, 0), "Wrong segment point");
+            ASSERT_EQUAL_HINT(seg.GetDerivativeByParam(3.0), TriDvector<double>(1 / std::sqrt(5.0), 2 / std::sqrt(5.0), 0), "Wrong segment tangent");
+
+            Arc<double> arc(2.0, 0, PI / 2);
+            Arc<double> back(2.0, 0, -PI / 2);
+            ASSERT_EQUAL_HINT(arc.GetPointByParam(1.0), Point<double>(0, 2, 0), "Wrong arc end");
+            ASSERT_EQUAL_HINT(arc.GetDerivativeByParam(0.0), TriDvector<double>(0, 1, 0), "Wrong arc tangent");
+            ASSERT_EQUAL_HINT(back.GetDerivativeByParam(0.0), TriDvector<double>(0, -1, 0), "Clockwise arc tangent must point down");
+
+            EllipticHelix<double> eh(3.0, 1.0, 2 * PI);
+            ASSERT_EQUAL_HINT(eh.GetPointByParam(PI / 2), Point<double>(0, 1, PI / 2), "Wrong elliptic helix point");
+            ASSERT_EQUAL_HINT(eh.GetDerivativeByParam(0.0), TriDvector<double>(0, 1 / std::sqrt(2.0), 1 / std::sqrt(2.0)), "Wrong elliptic helix tangent");
+
+            ConicalSpiral<double> cs(1.0, 0, 2 * PI);          // r(t) = 1 + t, flat
+            ASSERT_EQUAL_HINT(cs.GetPointByParam(PI), Point<double>(-(1 + PI), 0, 0), "Wrong conical spiral point");
+            ASSERT_EQUAL_HINT(cs.GetDerivativeByParam(0.0), TriDvector<double>(1 / std::sqrt(2.0), 1 / std::sqrt(2.0), 0), "Wrong conical spiral tangent");
+
+            BezierSegment<double> bz(Point<double>(0, 0, 0), Point<double>(1, 1, 0), Point<double>(2, 1, 0), Point<double>(3, 0, 0));
+            ASSERT_EQUAL_HINT(bz.GetPointByParam(0.5), Point<double>(1.5, 0.75, 0), "Wrong Bezier midpoint");
+            ASSERT_EQUAL_HINT(bz.GetDerivativeByParam(0.5), TriDvector<double>(1, 0, 0), "Wrong Bezier tangent");
+
+            BSplineSegment<double> bs(Point<double>(0, 0, 0), Point<double>(1, 0, 0), Point<double>(2, 0, 0), Point<double>(3, 0, 0));
+            ASSERT_EQUAL_HINT(bs.GetPointByParam(0.0), Point<double>(1, 0, 0), "B-spline must start at (P0 + 4P1 + P2) / 6");
+            ASSERT_EQUAL_HINT(bs.GetPointByParam(1.0), Point<double>(2, 0, 0), "B-spline must end at (P1 + 4P2 + P3) / 6");
+            ASSERT_EQUAL_HINT(bs.GetControlPoint(3), Point<double>(3, 0, 0), "B-spline lost its control point");
+        }
+        {       // coincident end control points: tangent follows the second derivative, not the chord
+            BezierSegment<double> head(Point<double>(0, 0, 0), Point<double>(0, 0, 0), Point<double>(1, 2, 0), Point<double>(3, 0, 1));
+            ASSERT_EQUAL_HINT(head.GetDerivativeByParam(0.0), TriDvector<double>(1 / std::sqrt(5.0), 2 / std::sqrt(5.0), 0), "Bezier tangent at P0 == P1 must point to P2");
+            BezierSegment<double> tail(Point<double>(0, 0, 1), Point<double>(1, 2, 0), Point<double>(3, 1, 0), Point<double>(3, 1, 0));
+            ASSERT_EQUAL_HINT(tail.GetDerivativeByParam(1.0), TriDvector<double>(2 / std::sqrt(5.0), -1 / std::sqrt(5.0), 0), "Bezier tangent at P2 == P3 must come from P1");
+            BezierSegment<double> cusp(Point<double>(0, 0, 0), Point<double>(0, 0, 0), Point<double>(0, 0, 0), Point<double>(1, 1, 0));
+            ASSERT_EQUAL_HINT(cusp.GetDerivativeByParam(0.0), TriDvector<double>(1 / std::sqrt(2.0), 1 / std::sqrt(2.0), 0), "Bezier tangent at three coincident points");
+            try {
+                BezierSegment<double> bad(Point<double>(1, 1, 1), Point<double>(1, 1, 1), Point<double>(1, 1, 1), Point<double>(1, 1, 1));
+                ASSERT_HINT(false, "No exception by BezierSegment with coinciding control points\n");
+            }
+            catch (const std::logic_error& e) {
+                if (std::strcmp(e.what(), "Spline control points must not all coincide") != 0)
+                    throw;
+            }
+        }
+        {       // batch, store and dispatch paths agree with the objects
+            Segment<double> seg(Point<double>(1, 2, 3), Point<double>(-1, 0, 5));
+            Arc<double> arc(2.0, 0.5, 3.0);
+            EllipticHelix<double> eh(3.0, 1.5, 0.7);
+            ConicalSpiral<double> cs(2.0, 1.0, 0.25);
+            BezierSegment<double> bz(Point<double>(0, 0, 0), Point<double>(1, 2, 0), Point<double>(3, 2, 1), Point<double>(4, 0, 2));
+            BSplineSegment<double> bs(Point<double>(0, 0, 0), Point<double>(1, 2, 0), Point<double>(3, 2, 1), Point<double>(4, 0, 2));
+            std::vector<Curve<double>*> curves{ &seg, &arc, &eh, &cs, &bz, &bs };
+            CurveStore<double> store = CurveStore<double>::FromCurves(curves);
+            const double params[] = { 0.0, 0.3, 1.0, -2.0, 1e4 };
+            double xs[5], ys[5], zs[5];
+            for (size_t i = 0; i < curves.size(); ++i) {
+                ASSERT_HINT(store.GetKind(i) == curves[i]->GetKind(), "Store lost curve kind");
+                curves[i]->GetPointsByParams(params, 5, xs, ys, zs);
+                for (int k = 0; k < 5; ++k) {
+                    const Point<double> p = curves[i]->GetPointByParam(params[k]);
+                    ASSERT_EQUAL_HINT(Point<double>(xs[k], ys[k], zs[k]), p, "Batch point differs from single evaluation");
+                    ASSERT_EQUAL_HINT(store.GetPointByParam(i, params[k]), p, "Store point differs from curve point");
+                    ASSERT_EQUAL_HINT(store.MakeCurve(i)->GetPointByParam(params[k]), p, "Materialized curve differs");
+                    ASSERT_EQUAL_HINT(store.GetDerivativeByParam(i, params[k]), curves[i]->GetDerivativeByParam(params[k]), "Store tangent differs");
+                }
+            }
+            try {
+                store.AddArc(1.0, 0, 0);
+                ASSERT_HINT(false, "No exception by CurveStore::AddArc with zero sweep\n");
+            }
+            catch (const std::logic_error& e) {
+                if (std::strcmp(e.what(), "Arc sweep must be non-zero") != 0)
+                    throw;
+            }
+            ASSERT_EQUAL_HINT(store.Size(), curves.size(), "Rejected curve got into the store");
+
+            // rows wider than the shared columns live in the kind pools
+            ASSERT_EQUAL_HINT(store.GetParam(4, 9), 4.0, "Bezier control point lost in the store");
+            ASSERT_EQUAL_HINT(store.GetParam(0, 7), 0.0, "Segment row not zero-padded");
+            store.SetParam(4, 10, 1.0);
+            ASSERT_EQUAL_HINT(store.GetPointByParam(4, 1.0), Point<double>(4, 1, 2), "Bezier control point not updated");
+            // BSpline evaluation runs on a cached Bezier form - edits must reach it
+            store.SetParam(5, 3, 2.0);
+            const double nudge[] = { 0.0, 0.0, 0.0, 0.0, 0.0, 1.0 };
+            store.ApplyDeltas(0, nudge);
+            BSplineSegment<double> moved(Point<double>(1, 0, 0), Point<double>(2, 2, 0), Point<double>(3, 2, 1), Point<double>(4, 0, 2));
+            ASSERT_EQUAL_HINT(store.GetPointByParam(5, 0.3), moved.GetPointByParam(0.3), "Edited BSpline evaluated from a stale form");
+            ASSERT_EQUAL_HINT(store.GetDerivativeByParam(5, 0.3), moved.GetDerivativeByParam(0.3), "Edited BSpline tangent from a stale form");
+            try {
+                store.SetParam(1, 4, 1.0);
+                ASSERT_HINT(false, "No exception by CurveStore::SetParam past the arc parameters\n");
+            }
+            catch (const std::logic_error& e) {
+                if (std::strcmp(e.what(), "Column is not a parameter of this curve kind") != 0)
+                    throw;
+            }
+
+            // shared memory copy packs every kind at its own width
+            ShardOptions opt;
+            opt.workers = 2;
+            opt.curves_per_shard = 1;
+            ShardedEvaluator<double> eval(store, 0.0, 1.0, 5, opt);
+            eval.Run();
+            for (size_t c = 0; c < store.Size(); ++c)
+                for (size_t k = 0; k < 5; ++k)
+                    ASSERT_EQUAL_HINT(eval.GetPoint(c, k), store.GetPointByParam(c, 0.25 * k), "Sharded point of a wide curve differs");
+        }
+    }
+
+    void PolylineCompression() {
+        CurveStore<double> store;
+        store.AddCircle(10.0);
+        store.AddEllipsis(30.0, 5.0);
+        store.AddHelix(4.0, 1.5);
+        const size_t n = 1000;
+        const double bound = 1e-3;
+        std::vector<double> params(n), xs(n), ys(n), zs(n), dx(n), dy(n), dz(n);
+        const double step = 20 * PI / (n - 1);
+        for (size_t i = 0; i < n; ++i)
+            params[i] = step * i;
+        for (size_t c = 0; c < store.Size(); ++c) {
+            store.GetPointsByParams(c, params.data(), n, xs.data(), ys.data(), zs.data());
+            const EncodedPolyline<double> enc = EncodePolyline(xs.data(), ys.data(), zs.data(), n, bound);
+            DecodePolyline(enc, dx.data(), dy.data(), dz.data());
+            for (size_t i = 0; i < n; ++i) {
+                const double err = std::sqrt((dx[i] - xs[i]) * (dx[i] - xs[i]) + (dy[i] - ys[i]) * (dy[i] - ys[i]) + (dz[i] - zs[i]) * (dz[i] - zs[i]));
+                ASSERT_HINT(err <= bound, "Decoded point is off by more than the error bound");
+            }
+            ASSERT_HINT(enc.GetByteSize() * 10 < n * 3 * sizeof(double), "Encoded polyline must be 10x smaller than dense points");
+
+            // descriptor rebuild is bit-exact with sampling through the store
+            const CurveDescriptor<double> desc = Describe(store, c, 0.0, 20 * PI, n);
+            Rebuild(desc, dx.data(), dy.data(), dz.data());
+            for (size_t i = 0; i < n; ++i)
+                ASSERT_HINT(dx[i] == xs[i] && dy[i] == ys[i] && dz[i] == zs[i], "Rebuilt polyline differs from sampled one");
+        }
+        {       // any input round-trips within the bound, narrow blocks and 64-bit ones alike
+            const double noisy[] = { 0.0, 1e8, -1e8, 3.3, 3.3, 3.3, -7e-4, 1e9 };
+            const double zero[8] = {};
+            const EncodedPolyline<double> enc = EncodePolyline(noisy, zero, noisy, 8, bound);
+            double ox[8], oy[8], oz[8];
+            DecodePolyline(enc, ox, oy, oz);
+            for (int i = 0; i < 8; ++i) {
+                ASSERT_HINT(std::fabs(ox[i] - noisy[i]) <= bound && oy[i] == 0 && std::fabs(oz[i] - noisy[i]) <= bound, "Noisy polyline lost precision");
+            }
+        }
+        try {
+            const double one = 1.0;
+            EncodePolyline(&one, &one, &one, 1, 0.0);
+            ASSERT_HINT(false, "No exception by EncodePolyline with zero error bound\n");
+        }
+        catch (const std::logic_error& e) {
+            if (std::strcmp(e.what(), "Error bound must be positive") != 0)
+                throw;
+        }
+        try {
+            const double huge = 1e12;
+            EncodePolyline(&huge, &huge, &huge, 1, bound);
+            ASSERT_HINT(false, "No exception by EncodePolyline with coordinates beyond 2^40 grid steps\n");
+        }
+        catch (const std::logic_error& e) {
+            if (std::strcmp(e.what(), "Polyline coordinates out of quantization range") != 0)
+                throw;
+        }
+    }
+
+    void AnimationUpdates() {
+        CurveStore<double> store;
+        store.AddCircle(5.0);
+        store.AddEllipsis(3.0, 1.0);
+        store.AddHelix(2.0, 0.5);
+        store.AddCircle(1.0);
+        store.AddCircle(3.0);
+        {       // one pass over a column, evaluation follows the new values
+            const double radii[] = { -1.0, 0.5, 1.0, 0.0, 2.5 };
+            const double steps[] = { 0.0, 0.25, -3.0, 0.0, 0.0 };          // ellipsis radY, helix step
+            store.ApplyDeltas(0, radii);
+            store.ApplyDeltas(1, steps);
+            ASSERT_EQUAL_HINT(store.GetPointByParam(0, 1.0), Circle<double>(4.0).GetPointByParam(1.0), "Circle radius not updated");
+            ASSERT_EQUAL_HINT(store.GetPointByParam(1, 1.0), Ellipsis<double>(3.5, 1.25).GetPointByParam(1.0), "Ellipsis axes not updated");
+            ASSERT_EQUAL_HINT(store.GetPointByParam(2, 7.0), Helix<double>(3.0, -2.5).GetPointByParam(7.0), "Helix not updated");
+        }
+        {       // invalid frame is rejected as a whole
+            const double bad[] = { -0.5, 0.0, 0.0, -1.0, 0.0 };              // second circle would get radius 0
+            try {
+                store.ApplyDeltas(0, bad);
+                ASSERT_HINT(false, "No exception by CurveStore::ApplyDeltas with radii <= 0\n");
+            }
+            catch (const std::logic_error& e) {
+                if (std::strcmp(e.what(), "Radii must be positive") != 0)
+                    throw;
+            }
+            ASSERT_EQUAL_HINT(store.GetParam(0, 0), 4.0, "Rejected deltas changed the store");
+            store.AddArc(1.0, 0.0, 1.0);
+            try {
+                store.SetParam(5, 2, 0.0);
+                ASSERT_HINT(false, "No exception by CurveStore::SetParam with zero arc sweep\n");
+            }
+            catch (const std::logic_error& e) {
+                if (std::strcmp(e.what(), "Arc sweep must be non-zero") != 0)
+                    throw;
+            }
+            ASSERT_EQUAL_HINT(store.GetParam(5, 2), 1.0, "Rejected value got into the store");
+            const double unsweep[] = { 0.0, 0.0, 0.0, 0.0, 0.0, -1.0 };
+            try {
+                store.ApplyDeltas(2, unsweep);
+                ASSERT_HINT(false, "No exception by CurveStore::ApplyDeltas with zero arc sweep\n");
+            }
+            catch (const std::logic_error& e) {
+                if (std::strcmp(e.what(), "Arc sweep must be non-zero") != 0)
+                    throw;
+            }
+            const double stray[] = { 0.5, 0.0, 0.0, 0.0, 0.0, 0.5 };           // circles have no column 2
+            try {
+                store.ApplyDeltas(2, stray);
+                ASSERT_HINT(false, "No exception by CurveStore::ApplyDeltas on a column the circle doesn't have\n");
+            }
+            catch (const std::logic_error& e) {
+                if (std::strcmp(e.what(), "Column is not a parameter of this curve kind") != 0)
+                    throw;
+            }
+            ASSERT_EQUAL_HINT(store.GetParam(5, 2), 1.0, "Rejected deltas changed the store");
+        }
+        {       // circles by radius as in main(), repaired frame after frame
+            SortedView<double> view(store, CurveKind::Circle, 0);          // radii 4, 2, 5.5
+            ASSERT_HINT((view.GetOrder() == std::vector<size_t>{ 3, 0, 4 }), "Wrong initial radius order");
+            const double shrink[] = { -3.5, 0.0, 0.0, 0.0, 0.0, 0.0 };      // 0.5, 2, 5.5
+            store.ApplyDeltas(0, shrink);
+            store.AddCircle(3.0);
+            store.AddHelix(1.0, 1.0);
+            view.Update(store);
+            ASSERT_HINT((view.GetOrder() == std::vector<size_t>{ 0, 3, 6, 4 }), "Radius order not repaired");
+        }
+        {       // tail columns: segment ends and spline points move the same way
+            CurveStore<double> shapes;
+            shapes.AddCircle(1.0);
+            shapes.AddSegment(Point<double>(0, 0, 0), Point<double>(1, 0, 0));
+            shapes.AddBSpline(Point<double>(0, 0, 0), Point<double>(1, 2, 0), Point<double>(3, 2, 1), Point<double>(4, 0, 2));
+            const double lift[] = { 0.0, 2.0, 1.0 };                         // end x of the segment, P1.x of the spline
+            shapes.ApplyDeltas(3, lift);
+            ASSERT_EQUAL_HINT(shapes.GetPointByParam(1, 1.0), Point<double>(3, 0, 0), "Segment end not updated");
+            BSplineSegment<double> moved(Point<double>(0, 0, 0), Point<double>(2, 2, 0), Point<double>(3, 2, 1), Point<double>(4, 0, 2));
+            ASSERT_EQUAL_HINT(shapes.GetPointByParam(2, 0.3), moved.GetPointByParam(0.3), "BSpline tail deltas evaluated from a stale form");
+            const double collapse[] = { 0.0, -3.0, 0.0 };                    // segment end back onto its start
+            try {
+                shapes.ApplyDeltas(3, collapse);
+                ASSERT_HINT(false, "No exception by CurveStore::ApplyDeltas collapsing a segment\n");
+            }
+            catch (const std::logic_error& e) {
+                if (std::strcmp(e.what(), "Segment ends must differ") != 0)
+                    throw;
+            }
+            const double beyond[] = { 0.0, 1.0, 0.0 };                       // segments end at column 5
+            try {
+                shapes.ApplyDeltas(6, beyond);
+                ASSERT_HINT(false, "No exception by CurveStore::ApplyDeltas past the segment row\n");
+            }
+            catch (const std::logic_error& e) {
+                if (std::strcmp(e.what(), "Column is not a parameter of this curve kind") != 0)
+                    throw;
+            }
+            ASSERT_EQUAL_HINT(shapes.GetParam(1, 3), 3.0, "Rejected tail deltas changed the store");
+        }
+    }
+
+#ifdef CURVES_PROFILE
+    void ProfileCounters() {
+        {
+            using CurvesProfile::Counter;
+            auto& reg = CurvesProfile::Registry::Get();
+            const uint64_t circle_before = reg.GetCounter(Counter::CircleEval);
+            const uint64_t helix_before = reg.GetCounter(Counter::HelixDeriv);
+            const uint64_t norm_before = reg.GetCounter(Counter::Normalize);
+
+            Circle<double> c(1.0);
+            Helix<double> h(1.0, 2.0);
+            c.GetPointByParam(0.0);
+            c.GetPointByParam(1.0);
+            h.GetDerivativeByParam(0.5);
+
+            ASSERT_EQUAL_HINT(reg.GetCounter(Counter::CircleEval) - circle_before, 2u, "Circle evaluations not counted");
+            ASSERT_EQUAL_HINT(reg.GetCounter(Counter::HelixDeriv) - helix_before, 1u, "Helix derivatives not counted");
+            ASSERT_EQUAL_HINT(reg.GetCounter(Counter::Normalize) - norm_before, 1u, "Normalize calls not counted");
+        }
+        {
+            CurvesProfile::Histogram h("test");
+            h.Add(0);
+            h.Add(1);
+            h.Add(1000);
+            ASSERT_EQUAL_HINT(h.GetCount(), 3u, "Histogram lost samples");
+            ASSERT_EQUAL_HINT(h.GetBucket(0), 1u, "0 ns must land into bucket 0");
+            ASSERT_EQUAL_HINT(h.GetBucket(10), 1u, "1000 ns must land into bucket [512, 1024)");
+        }
+    }
+#endif
+
     void RunTests() {
         RUN_TEST(PointConstruction);
         RUN_TEST(PointEqualityCheck);
@@ -477,6 +1230,22 @@ namespace MyUnitTests {
         RUN_TEST(HelixConstruction);
         RUN_TEST(HelixGetPointByParam);
         RUN_TEST(HelixDerivative);
+        RUN_TEST(HelixLargeParam);
+        RUN_TEST(IntersectionCurvePlane);
+        RUN_TEST(IntersectionCurveCurve);
+        RUN_TEST(LazyPointChunks);
+        RUN_TEST(BulkConstruction);
+        RUN_TEST(CurveMetrics);
+        RUN_TEST(CurveStoreEvaluation);
+        RUN_TEST(ShardedEvaluation);
+        RUN_TEST(StagePipeline);
+        RUN_TEST(PrecomputedEvaluators);
+        RUN_TEST(ExtraPrimitives);
+        RUN_TEST(PolylineCompression);
+        RUN_TEST(AnimationUpdates);
+#ifdef CURVES_PROFILE
+        RUN_TEST(ProfileCounters);
+#endif
         cerr << "Tests done\n";
     }
 
@@ -0,0 +1,435 @@
+// Randomized differential tests: every accelerated evaluation path against the reference
+// scalar GetPointByParam / GetDerivativeByParam, the scalar path itself against long double libm,
+// and the bulk builders' accept/reject decisions against the constructors. Separate target, so it can run
+// many more cases than the unit tests in main().
+//
+// usage: curves_t_proptests [cases per path] [seed]
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "curve.h"
+#include "circle.h"
+#include "ellipsis.h"
+#include "helix.h"
+#include "generator.h"
+#include "bulk.h"
+#include "evaluator.h"
+#include "curve_store.h"
+#include "segment.h"
+#include "arc.h"
+#include "elliptic_helix.h"
+#include "conical_spiral.h"
+#include "bezier.h"
+#include "bspline.h"
+#include "polyline_codec.h"
+
+namespace PropTests {
+
+	// One random input. Paths decide what a, b mean (radii, step...)
+	struct Case {
+		double a = 1;
+		double b = 1;
+		double t = 0;
+	};
+
+	std::ostream& operator<<(std::ostream& os, const Case& c) {
+		os.precision(17);
+		os << "{ a = " << c.a << ", b = " << c.b << ", t = " << c.t << " }";
+		return os;
+	}
+
+	struct Diff {
+		uint64_t ulp = 0;
+		double abs = 0;
+	};
+
+	// Doubles mapped to integers monotonically - difference is the number of representable values between
+	int64_t Ordered(double v) {
+		int64_t i;
+		std::memcpy(&i, &v, sizeof(i));
+		return i < 0 ? std::numeric_limits<int64_t>::min() - i : i;
+	}
+
+	uint64_t UlpDistance(double a, double b) {
+		if (std::isnan(a) || std::isnan(b))
+			return (std::isnan(a) && std::isnan(b)) ? 0 : std::numeric_limits<uint64_t>::max();
+		const int64_t ia = Ordered(a);
+		const int64_t ib = Ordered(b);
+		return ia > ib ? static_cast<uint64_t>(ia) - static_cast<uint64_t>(ib) : static_cast<uint64_t>(ib) - static_cast<uint64_t>(ia);
+	}
+
+	void Accumulate(Diff& d, double fast, double ref) {
+		d.ulp = std::max(d.ulp, UlpDistance(fast, ref));
+		d.abs = std::max(d.abs, std::fabs(fast - ref));
+	}
+
+	void Accumulate(Diff& d, const Point<double>& fast, const Point<double>& ref) {
+		Accumulate(d, fast.GetX(), ref.GetX());
+		Accumulate(d, fast.GetY(), ref.GetY());
+		Accumulate(d, fast.GetZ(), ref.GetZ());
+	}
+
+	// How a path judges a case
+	enum class Check {
+		UlpOrAbs,		// fails only if off by both measures: ULP alone is meaningless near zero (cos(PI/2)), abs alone - for big coordinates
+		Abs,			// lossy by design (codec, float-normalized tangents) - absolute error only, ULP says nothing there
+		Relative,		// against an independent reference; compare() returns the relative error in abs
+		Verdict,		// accept/reject decisions; compare() returns the number of disagreements in abs
+	};
+
+	struct Path {
+		std::string name;
+		std::function<Case(std::mt19937_64&)> generate;
+		std::function<Diff(const Case&)> compare;
+		uint64_t max_ulp;
+		double max_abs;
+		Check check = Check::UlpOrAbs;
+	};
+
+	bool Fails(const Path& p, const Diff& d) {
+		if (p.check == Check::UlpOrAbs)
+			return d.ulp > p.max_ulp && d.abs > p.max_abs;
+		return d.abs > p.max_abs;
+	}
+
+	bool Fails(const Path& p, const Case& c) {
+		return Fails(p, p.compare(c));
+	}
+
+	// Only the measures the path is judged by
+	void Print(std::ostream& os, const Path& p, const Diff& d) {
+		switch (p.check) {
+		case Check::UlpOrAbs:
+			os << "max ulp = " << d.ulp << ", max abs = " << d.abs;
+			break;
+		case Check::Abs:
+			os << "max abs = " << d.abs;
+			break;
+		case Check::Relative:
+			os << "max rel = " << d.abs;
+			break;
+		case Check::Verdict:
+			os << "disagreements = " << d.abs;
+			break;
+		}
+	}
+
+	// Greedy shrinking: try simpler values for every field, keep any that still fails
+	Case Shrink(const Path& p, Case c) {
+		bool progress = true;
+		for (int round = 0; progress && round < 200; ++round) {
+			progress = false;
+			for (double Case::* field : { &Case::t, &Case::a, &Case::b }) {
+				const double v = c.*field;
+				for (double cand : { 0.0, 1.0, std::round(v), v / 2, std::trunc(v * 1000) / 1000 }) {
+					if (cand == v || std::fabs(cand) > std::fabs(v))
+						continue;
+					Case next = c;
+					next.*field = cand;
+					try {
+						if (Fails(p, next)) {
+							c = next;
+							progress = true;
+							break;
+						}
+					}
+					catch (const std::logic_error&) {
+						// invalid curve parameters - not a simpler case
+					}
+				}
+			}
+		}
+		return c;
+	}
+
+	/******************************** GENERATORS ****************************************/
+
+	double LogUniform(std::mt19937_64& gen, double lo, double hi) {
+		std::uniform_real_distribution<double> d(std::log(lo), std::log(hi));
+		return std::exp(d(gen));
+	}
+
+	// Mostly ordinary parameters, sometimes deep ones (thousands+ of turns)
+	double RandomParam(std::mt19937_64& gen) {
+		std::uniform_int_distribution<int> kind(0, 3);
+		std::uniform_real_distribution<double> small(-10, 10);
+		switch (kind(gen)) {
+		case 0: return 0;
+		case 1: return LogUniform(gen, 1e2, 1e7) * (small(gen) < 0 ? -1 : 1);
+		default: return small(gen);
+		}
+	}
+
+	Case RadiusRadius(std::mt19937_64& gen) {
+		return { LogUniform(gen, 1e-3, 1e3), LogUniform(gen, 1e-3, 1e3), RandomParam(gen) };
+	}
+
+	Case RadiusStep(std::mt19937_64& gen) {
+		std::uniform_real_distribution<double> step(-1e3, 1e3);
+		return { LogUniform(gen, 1e-3, 1e3), step(gen), RandomParam(gen) };
+	}
+
+	// Anything a data file can hold: special values half of the time
+	double WildValue(std::mt19937_64& gen) {
+		const double specials[] = {
+			std::numeric_limits<double>::quiet_NaN(), std::numeric_limits<double>::infinity(), -std::numeric_limits<double>::infinity(),
+			0.0, -0.0, std::numeric_limits<double>::max(), std::numeric_limits<double>::lowest(), std::numeric_limits<double>::denorm_min()
+		};
+		std::uniform_int_distribution<size_t> pick(0, 2 * std::size(specials) - 1);
+		std::uniform_real_distribution<double> sign(-1, 1);
+		const size_t i = pick(gen);
+		if (i < std::size(specials))
+			return specials[i];
+		return LogUniform(gen, 1e-300, 1e300) * (sign(gen) < 0 ? -1 : 1);
+	}
+
+	Case Wild(std::mt19937_64& gen) {
+		return { WildValue(gen), WildValue(gen), 0 };
+	}
+
+	/******************************** COMPARATORS ****************************************/
+
+	const size_t BATCH = 19;				// odd size - covers vector loop remainders too
+
+	Diff BatchVsScalar(const Curve<double>& c, double t) {
+		double params[BATCH], xs[BATCH], ys[BATCH], zs[BATCH];
+		for (size_t i = 0; i < BATCH; ++i)
+			params[i] = t + 0.37 * i;
+		c.GetPointsByParams(params, BATCH, xs, ys, zs);
+		Diff d;
+		for (size_t i = 0; i < BATCH; ++i)
+			Accumulate(d, Point<double>(xs[i], ys[i], zs[i]), c.GetPointByParam(params[i]));
+		return d;
+	}
+
+	Diff GeneratorVsScalar(const Curve<double>& c, double t) {
+		const size_t count = 50;
+		const double t1 = t + 10;
+		const double step = (t1 - t) / (count - 1);
+		Diff d;
+		size_t i = 0;
+		for (const Point<double>& p : SamplePoints(c, t, t1, count, 7))
+			Accumulate(d, p, c.GetPointByParam(t + step * static_cast<double>(i++)));
+		return d;
+	}
+
+	// Structure-of-arrays store goes through its own kind dispatch - must land on the same code
+	template <typename C>
+	Diff StoreVsCurve(C c, double t) {
+		const CurveStore<double> store = CurveStore<double>::FromCurves({ &c });
+		Diff d;
+		Accumulate(d, store.GetPointByParam(0, t), c.GetPointByParam(t));
+		Accumulate(d, store.GetDerivativeByParam(0, t).MakePoint(), c.GetDerivativeByParam(t).MakePoint());
+		return d;
+	}
+
+	// Lossy by design: every coordinate must come back within bound / sqrt(3).
+	// Deep helix z reaches ~1e9, so the bound there keeps it inside 2^40 grid steps
+	const double CODEC_BOUND = 1e-4;
+	const double DEEP_CODEC_BOUND = 1e-2;
+
+	Diff CodecVsSamples(const Curve<double>& c, double t, double bound) {
+		double params[BATCH], xs[BATCH], ys[BATCH], zs[BATCH], dx[BATCH], dy[BATCH], dz[BATCH];
+		for (size_t i = 0; i < BATCH; ++i)
+			params[i] = t + 0.37 * i;
+		c.GetPointsByParams(params, BATCH, xs, ys, zs);
+		DecodePolyline(EncodePolyline(xs, ys, zs, BATCH, bound), dx, dy, dz);
+		Diff d;
+		for (size_t i = 0; i < BATCH; ++i)
+			Accumulate(d, Point<double>(dx[i], dy[i], dz[i]), Point<double>(xs[i], ys[i], zs[i]));
+		return d;
+	}
+
+	// Parameters changed in place must evaluate as a freshly built curve
+	Diff DeltasVsFresh(const Case& k) {
+		CurveStore<double> store;
+		store.AddHelix(k.a, k.b);
+		const double grow = 0.5 * k.a;
+		const double turn = -k.b / 3;
+		store.ApplyDeltas(0, &grow);
+		store.ApplyDeltas(1, &turn);
+		const Helix<double> fresh(k.a + grow, k.b + turn);
+		Diff d;
+		Accumulate(d, store.GetPointByParam(0, k.t), fresh.GetPointByParam(k.t));
+		Accumulate(d, store.GetDerivativeByParam(0, k.t).MakePoint(), fresh.GetDerivativeByParam(k.t).MakePoint());
+		return d;
+	}
+
+	// Spline control polygon out of two random values
+	template <typename S>
+	S MakeSpline(const Case& k) {
+		return S(Point<double>(0, 0, 0), Point<double>(k.a, k.b, 0), Point<double>(k.b, -k.a, k.a), Point<double>(k.a + k.b, 0, k.b));
+	}
+
+	// Precomputed evaluator against the curve object it was built from
+	template <typename C>
+	Diff EvaluatorPoint(const C& c, double t) {
+		double x, y, z;
+		MakeEvaluator(c).GetPoint(t, x, y, z);
+		Diff d;
+		Accumulate(d, Point<double>(x, y, z), c.GetPointByParam(t));
+		return d;
+	}
+
+	template <typename C>
+	Diff EvaluatorTangent(const C& c, double t) {
+		double x, y, z;
+		MakeEvaluator(c).GetTangent(t, x, y, z);
+		Diff d;
+		Accumulate(d, Point<double>(x, y, z), c.GetDerivativeByParam(t).MakePoint());
+		return d;
+	}
+
+	// Bulk builders skip a record exactly when its constructor throws
+	template <typename Make>
+	bool Throws(Make&& make) {
+		try {
+			make();
+			return false;
+		}
+		catch (const std::logic_error&) {
+			return true;
+		}
+	}
+
+	Diff BulkVerdicts(const Case& k) {
+		const std::vector<double> as{ k.a };
+		const std::vector<double> bs{ k.b };
+		std::vector<Circle<double>> circles;
+		std::vector<Ellipsis<double>> ellipses;
+		std::vector<Helix<double>> helices;
+		const bool circle = !BuildCircles(as, circles).IsValid(0);
+		const bool ellipsis = !BuildEllipses(as, bs, ellipses).IsValid(0);
+		const bool helix = !BuildHelices(as, bs, helices).IsValid(0);
+		Diff d;
+		d.abs += circle != Throws([&k] { Circle<double> c(k.a); });
+		d.abs += ellipsis != Throws([&k] { Ellipsis<double> e(k.a, k.b); });
+		d.abs += helix != Throws([&k] { Helix<double> h(k.a, k.b); });
+		return d;
+	}
+
+	// Independent reference: long double libm on the raw parameter - no RangeReduction involved.
+	// Curve is x = radX cos t, y = radY sin t, z = step * t / 2PI.
+	// x, y errors are relative to the radius (what the angle error scales with), z error - to z itself
+	Diff AgainstLongDouble(const Curve<double>& c, long double radX, long double radY, long double step, double t) {
+		const long double two_pi = 6.28318530717958647692528676655900577L;
+		const long double lt = t;
+		const long double x = radX * std::cos(lt);
+		const long double y = radY * std::sin(lt);
+		const long double z = step * lt / two_pi;
+		const Point<double> p = c.GetPointByParam(t);
+		Diff d;
+		d.abs = static_cast<double>(std::max({
+			std::fabs(p.GetX() - x) / radX,
+			std::fabs(p.GetY() - y) / radY,
+			z == 0 ? std::fabs(static_cast<long double>(p.GetZ())) : std::fabs((p.GetZ() - z) / z) }));
+		return d;
+	}
+
+	std::vector<Path> MakePaths() {
+		std::vector<Path> ret;
+		ret.push_back({ "Circle batch", RadiusRadius,
+			[](const Case& k) { return BatchVsScalar(Circle<double>(k.a), k.t); }, 4, 1e-12 });
+		ret.push_back({ "Ellipsis batch", RadiusRadius,
+			[](const Case& k) { return BatchVsScalar(Ellipsis<double>(k.a, k.b), k.t); }, 4, 1e-12 });
+		ret.push_back({ "Helix batch", RadiusStep,
+			[](const Case& k) { return BatchVsScalar(Helix<double>(k.a, k.b), k.t); }, 4, 1e-12 });
+		ret.push_back({ "Circle generator", RadiusRadius,
+			[](const Case& k) { return GeneratorVsScalar(Circle<double>(k.a), k.t); }, 0, 0 });
+		ret.push_back({ "Helix generator", RadiusStep,
+			[](const Case& k) { return GeneratorVsScalar(Helix<double>(k.a, k.b), k.t); }, 0, 0 });
+		ret.push_back({ "Bulk vs constructor verdicts", Wild, BulkVerdicts, 0, 0, Check::Verdict });
+		// a few ulp even a million turns out; reducing by a rounded 2PI is ~1e-10 off there
+		const double REDUCTION_REL = 4 * std::numeric_limits<double>::epsilon();
+		ret.push_back({ "Circle vs long double", RadiusRadius,
+			[](const Case& k) { return AgainstLongDouble(Circle<double>(k.a), k.a, k.a, 0, k.t); }, 0, REDUCTION_REL, Check::Relative });
+		ret.push_back({ "Ellipsis vs long double", RadiusRadius,
+			[](const Case& k) { return AgainstLongDouble(Ellipsis<double>(k.a, k.b), k.a, k.b, 0, k.t); }, 0, REDUCTION_REL, Check::Relative });
+		ret.push_back({ "Helix vs long double", RadiusStep,
+			[](const Case& k) { return AgainstLongDouble(Helix<double>(k.a, k.b), k.a, k.a, k.b, k.t); }, 0, REDUCTION_REL, Check::Relative });
+		ret.push_back({ "Segment batch", RadiusRadius,
+			[](const Case& k) { return BatchVsScalar(Segment<double>(Point<double>(k.a, 0, -k.b), Point<double>(-k.b, k.a, 1)), k.t); }, 4, 1e-12 });
+		ret.push_back({ "Arc batch", RadiusRadius,
+			[](const Case& k) { return BatchVsScalar(Arc<double>(k.a, k.b, -2.0), k.t); }, 4, 1e-12 });
+		ret.push_back({ "EllipticHelix batch", RadiusStep,
+			[](const Case& k) { return BatchVsScalar(EllipticHelix<double>(k.a, 2 * k.a, k.b), k.t); }, 4, 1e-12 });
+		ret.push_back({ "ConicalSpiral batch", RadiusStep,
+			[](const Case& k) { return BatchVsScalar(ConicalSpiral<double>(k.a, k.b, 0.1 * k.b), k.t); }, 4, 1e-12 });
+		ret.push_back({ "Bezier batch", RadiusRadius,
+			[](const Case& k) { return BatchVsScalar(MakeSpline<BezierSegment<double>>(k), k.t); }, 4, 1e-12 });
+		ret.push_back({ "BSpline batch", RadiusRadius,
+			[](const Case& k) { return BatchVsScalar(MakeSpline<BSplineSegment<double>>(k), k.t); }, 4, 1e-12 });
+		ret.push_back({ "ConicalSpiral store", RadiusStep,
+			[](const Case& k) { return StoreVsCurve(ConicalSpiral<double>(k.a, k.b, 0.1 * k.b), k.t); }, 0, 0 });
+		ret.push_back({ "BSpline store", RadiusRadius,
+			[](const Case& k) { return StoreVsCurve(MakeSpline<BSplineSegment<double>>(k), k.t); }, 0, 0 });
+		ret.push_back({ "Helix store deltas", RadiusStep, DeltasVsFresh, 0, 0 });
+		ret.push_back({ "Ellipsis polyline codec", RadiusRadius,
+			[](const Case& k) { return CodecVsSamples(Ellipsis<double>(k.a, k.b), k.t, CODEC_BOUND); }, 0, CODEC_BOUND / std::sqrt(3.0), Check::Abs });
+		ret.push_back({ "Helix polyline codec", RadiusStep,
+			[](const Case& k) { return CodecVsSamples(Helix<double>(k.a, k.b), k.t, DEEP_CODEC_BOUND); }, 0, DEEP_CODEC_BOUND / std::sqrt(3.0), Check::Abs });
+		ret.push_back({ "Circle evaluator point", RadiusRadius,
+			[](const Case& k) { return EvaluatorPoint(Circle<double>(k.a), k.t); }, 0, 0 });
+		ret.push_back({ "Ellipsis evaluator point", RadiusRadius,
+			[](const Case& k) { return EvaluatorPoint(Ellipsis<double>(k.a, k.b), k.t); }, 0, 0 });
+		ret.push_back({ "Helix evaluator point", RadiusStep,
+			[](const Case& k) { return EvaluatorPoint(Helix<double>(k.a, k.b), k.t); }, 0, 0 });
+		// reference tangents are normalized through float sqrtf - unit vectors, float precision
+		ret.push_back({ "Circle evaluator tangent", RadiusRadius,
+			[](const Case& k) { return EvaluatorTangent(Circle<double>(k.a), k.t); }, 0, 1e-6, Check::Abs });
+		ret.push_back({ "Ellipsis evaluator tangent", RadiusRadius,
+			[](const Case& k) { return EvaluatorTangent(Ellipsis<double>(k.a, k.b), k.t); }, 0, 1e-6, Check::Abs });
+		ret.push_back({ "Helix evaluator tangent", RadiusStep,
+			[](const Case& k) { return EvaluatorTangent(Helix<double>(k.a, k.b), k.t); }, 0, 1e-6, Check::Abs });
+		return ret;
+	}
+
+	/******************************** RUNNER ****************************************/
+
+	bool RunPath(const Path& p, size_t cases, uint64_t seed) {
+		std::mt19937_64 gen(seed);
+		Diff worst;
+		for (size_t i = 0; i < cases; ++i) {
+			const Case c = p.generate(gen);
+			const Diff d = p.compare(c);
+			worst.ulp = std::max(worst.ulp, d.ulp);
+			worst.abs = std::max(worst.abs, d.abs);
+			if (Fails(p, d)) {
+				const Case minimal = Shrink(p, c);
+				std::cerr << p.name << " FAILED on case #" << i << " " << c << "\n";
+				std::cerr << "  shrunk to " << minimal << ": ";
+				Print(std::cerr, p, p.compare(minimal));
+				std::cerr << " (allowed ";
+				Print(std::cerr, p, Diff{ p.max_ulp, p.max_abs });
+				std::cerr << ")\n";
+				return false;
+			}
+		}
+		std::cerr << p.name << " OK: " << cases << " cases, ";
+		Print(std::cerr, p, worst);
+		std::cerr << "\n";
+		return true;
+	}
+
+}		// namespace PropTests
+
+int main(int argc, char** argv) {
+	const size_t cases = argc > 1 ? std::stoul(argv[1]) : 20000;
+	const uint64_t seed = argc > 2 ? std::stoull(argv[2]) : 20221019;
+
+	bool ok = true;
+	for (const PropTests::Path& p : PropTests::MakePaths())
+		ok = PropTests::RunPath(p, cases, seed) && ok;
+
+	std::cerr << (ok ? "Property tests done\n" : "Property tests FAILED\n");
+	return ok ? 0 : 1;
+}